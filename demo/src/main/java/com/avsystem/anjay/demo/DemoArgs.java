@@ -241,6 +241,12 @@ public class DemoArgs {
     @Parameter(names = "--nstart", description = "Configures NSTART (defined in RFC7252)")
     public Integer nstart = 1;
 
+    @Parameter(
+            names = "--fleet-size",
+            description =
+                    "Runs this many NoSec clients named ENDPOINT_NAME-N on a single AnjayFleet instead of the interactive demo")
+    public Integer fleetSize = 0;
+
     @Parameter(
             names = {"-h", "--help"},
             description = "shows this message and exits",
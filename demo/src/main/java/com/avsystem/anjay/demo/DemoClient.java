@@ -65,6 +65,7 @@ public final class DemoClient implements Runnable {
     public DemoArgs args;
 
     private AnjayIpsoButton button;
+    private DemoObject demoObject;
 
     public void pressButton() {
         button.update(0, true);
@@ -74,6 +75,10 @@ public final class DemoClient implements Runnable {
         button.update(0, false);
     }
 
+    public DemoObject getDemoObject() {
+        return demoObject;
+    }
+
     class FirmwareUpdateHandlers implements AnjayFirmwareUpdateHandlers {
         private File file;
         private FileOutputStream stream;
@@ -172,6 +177,10 @@ public final class DemoClient implements Runnable {
                                 this.args.maxRetransmit,
                                 this.args.nstart));
         this.config.msgCacheSize = this.args.cacheSize;
+        this.config.lwm2mVersionConfig =
+                Optional.of(
+                        new Anjay.Lwm2mVersionConfig(
+                                this.args.minimumVersion, this.args.maximumVersion));
     }
 
     private Optional<byte[]> readFile(String path) throws IOException {
@@ -351,8 +360,8 @@ public final class DemoClient implements Runnable {
             this.attrStorage = AnjayAttrStorage.install(anjay);
             this.accessControl = AnjayAccessControl.install(anjay);
             this.demoCommands = new DemoCommands(anjay, this, this.attrStorage, this.accessControl);
-            DemoObject demoObject = new DemoObject();
-            anjay.registerObject(demoObject);
+            this.demoObject = new DemoObject();
+            anjay.registerObject(this.demoObject);
 
             InitialState initialState = new InitialState();
             FirmwareUpdateHandlers fwuHandlers = new FirmwareUpdateHandlers();
@@ -27,8 +27,11 @@ import com.avsystem.anjay.AnjayDownloadHandlers;
 import com.avsystem.anjay.AnjayEventLoop;
 import com.avsystem.anjay.AnjaySecurityConfig;
 import com.avsystem.anjay.AnjaySecurityInfoPsk;
+import com.avsystem.anjay.AnjaySend;
 import java.io.File;
 import java.io.FileOutputStream;
+import java.net.InetAddress;
+import java.nio.ByteBuffer;
 import java.time.Duration;
 import java.time.Instant;
 import java.util.Arrays;
@@ -39,6 +42,7 @@ import java.util.Map;
 import java.util.Optional;
 import java.util.Set;
 import java.util.concurrent.LinkedBlockingQueue;
+import java.util.concurrent.atomic.AtomicLong;
 import java.util.logging.Level;
 import java.util.logging.Logger;
 
@@ -49,6 +53,8 @@ public final class DemoCommands {
     private AnjayAccessControl accessControl;
     private LinkedBlockingQueue<String> commands;
     private Map<String, DemoCommand> registeredCommands;
+    private AnjaySend send;
+    private final AtomicLong hostStubLookups = new AtomicLong();
 
     interface DemoCommand {
         public void apply(String[] args) throws Exception;
@@ -405,6 +411,57 @@ public final class DemoCommands {
         }
     }
 
+    class SendConfigCmd implements DemoCommand {
+        @Override
+        public void apply(String[] args) throws Exception {
+            if (args.length != 2 && args.length != 3) {
+                Logger.getAnonymousLogger()
+                        .log(
+                                Level.SEVERE,
+                                "unsupported format, must be \"send-config ssid max_samples [max_delay_ms]\"");
+                return;
+            }
+            AnjaySend.Configuration config = new AnjaySend.Configuration();
+            config.ssid = Integer.parseInt(args[0]);
+            config.maxSamples = Integer.parseInt(args[1]);
+            if (args.length == 3) {
+                config.maxDelay = Optional.of(Duration.ofMillis(Long.parseLong(args[2])));
+            }
+            if (DemoCommands.this.send != null) {
+                DemoCommands.this.send.close();
+            }
+            DemoCommands.this.send =
+                    AnjaySend.create(
+                            DemoCommands.this.anjay,
+                            config,
+                            (sampleCount, result, details) -> {
+                                System.out.println("SEND_FINISHED==" + sampleCount + "," + result);
+                            });
+        }
+    }
+
+    class SendAddCmd implements DemoCommand {
+        @Override
+        public void apply(String[] args) throws Exception {
+            if (args.length != 4) {
+                Logger.getAnonymousLogger()
+                        .log(
+                                Level.SEVERE,
+                                "unsupported format, must be \"send-add oid iid rid value\"");
+                return;
+            }
+            if (DemoCommands.this.send == null) {
+                Logger.getAnonymousLogger().log(Level.SEVERE, "send-config not called");
+                return;
+            }
+            DemoCommands.this.send.add(
+                    Integer.parseInt(args[0]),
+                    Integer.parseInt(args[1]),
+                    Integer.parseInt(args[2]),
+                    Long.parseLong(args[3]));
+        }
+    }
+
     class PressButtonCmd implements DemoCommand {
         @Override
         public void apply(String[] args) throws Exception {
@@ -419,6 +476,48 @@ public final class DemoCommands {
         }
     }
 
+    class IngestSampleCmd implements DemoCommand {
+        @Override
+        public void apply(String[] args) throws Exception {
+            if (args.length != 1) {
+                throw new RuntimeException("unsupported format, must be \"value\"");
+            }
+
+            double value = Double.parseDouble(args[0]);
+            DemoObject demoObject = demoClient.getDemoObject();
+            demoObject.setDoubleValue(value);
+            DemoCommands.this.anjay.ingestSample(demoObject.oid(), 1, 3, value);
+        }
+    }
+
+    class SetHostStubCmd implements DemoCommand {
+        @Override
+        public void apply(String[] args) throws Exception {
+            if (args.length != 4) {
+                throw new RuntimeException(
+                        "unsupported format, must be \"host address cacheTtlMs delayMs\"");
+            }
+
+            String stubbedHost = args[0];
+            InetAddress address =
+                    InetAddress.getByAddress(
+                            stubbedHost, InetAddress.getByName(args[1]).getAddress());
+            long delayMs = Long.parseLong(args[3]);
+            DemoCommands.this.hostStubLookups.set(0);
+            Anjay.setHostResolver(
+                    host -> {
+                        if (!host.equals(stubbedHost)) {
+                            return InetAddress.getAllByName(host);
+                        }
+                        long lookups = DemoCommands.this.hostStubLookups.incrementAndGet();
+                        System.out.println("HOST_STUB_LOOKUP==" + host + "," + lookups);
+                        Thread.sleep(delayMs);
+                        return new InetAddress[] {address};
+                    },
+                    Duration.ofMillis(Long.parseLong(args[2])));
+        }
+    }
+
     static class DownloadHandlers implements AnjayDownloadHandlers {
         private final File file;
         private final FileOutputStream stream;
@@ -428,8 +527,10 @@ public final class DemoCommands {
             this.stream = new FileOutputStream(file, false);
         }
 
-        public void onNextBlock(byte[] args, Optional<byte[]> etag) throws Exception {
-            this.stream.write(args);
+        public void onNextBlock(ByteBuffer data, Optional<byte[]> etag) throws Exception {
+            while (data.hasRemaining()) {
+                this.stream.getChannel().write(data);
+            }
         }
 
         public void onDownloadFinished(
@@ -475,6 +576,15 @@ public final class DemoCommands {
         registeredCommands.put("remove-server", new RemoveServerCmd());
         registeredCommands.put("press-button", new PressButtonCmd());
         registeredCommands.put("release-button", new ReleaseButtonCmd());
+        registeredCommands.put("ingest-sample", new IngestSampleCmd());
+        registeredCommands.put("set-host-stub", new SetHostStubCmd());
+        registeredCommands.put(
+                "host-stub-lookups",
+                (args) -> {
+                    System.out.println("HOST_STUB_LOOKUPS==" + this.hostStubLookups.get());
+                });
+        registeredCommands.put("send-config", new SendConfigCmd());
+        registeredCommands.put("send-add", new SendAddCmd());
     }
 
     private Set<Anjay.Transport> parseTransports(String[] args) throws Exception {
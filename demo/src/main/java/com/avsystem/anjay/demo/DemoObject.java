@@ -55,6 +55,10 @@ public final class DemoObject implements AnjayObject {
         public static final int INCREMENT_INTEGER = 10;
     }
 
+    public void setDoubleValue(double value) {
+        this.doubleValue = Optional.of(value);
+    }
+
     @Override
     public int oid() {
         return 1337;
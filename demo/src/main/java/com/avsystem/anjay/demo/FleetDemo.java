@@ -0,0 +1,101 @@
+/*
+ * Copyright 2020-2024 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package com.avsystem.anjay.demo;
+
+import com.avsystem.anjay.Anjay;
+import com.avsystem.anjay.AnjayFleet;
+import com.avsystem.anjay.AnjaySecurityObject;
+import com.avsystem.anjay.AnjayServerObject;
+import java.io.BufferedReader;
+import java.io.IOException;
+import java.io.InputStreamReader;
+import java.util.ArrayList;
+import java.util.List;
+import java.util.Optional;
+import java.util.logging.Level;
+import java.util.logging.Logger;
+
+/**
+ * Runs many simulated endpoints on a single {@link AnjayFleet}, e.g. to load-test a server. Each
+ * endpoint registers to the configured server with NoSec, as <code>ENDPOINT_NAME-N</code>.
+ */
+public class FleetDemo implements Runnable {
+    private final DemoArgs args;
+
+    public FleetDemo(DemoArgs args) {
+        this.args = args;
+    }
+
+    private Anjay createClient(int index) throws Exception {
+        Anjay.Configuration config = new Anjay.Configuration();
+        config.endpointName = this.args.endpointName + "-" + index;
+        // Buffers are allocated per client, so keep them small for large fleets.
+        config.inBufferSize = 1024;
+        config.outBufferSize = 1024;
+        config.msgCacheSize = 0;
+        Anjay anjay = new Anjay(config);
+
+        AnjaySecurityObject.Instance securityInstance = new AnjaySecurityObject.Instance();
+        securityInstance.ssid = 1;
+        securityInstance.serverUri = Optional.of(this.args.serverUri);
+        securityInstance.securityMode = AnjaySecurityObject.SecurityMode.NOSEC;
+        AnjaySecurityObject.install(anjay).addInstance(securityInstance);
+
+        AnjayServerObject.Instance serverInstance = new AnjayServerObject.Instance();
+        serverInstance.ssid = 1;
+        serverInstance.lifetime = this.args.lifetime;
+        serverInstance.binding = "U";
+        AnjayServerObject.install(anjay).addInstance(serverInstance);
+        return anjay;
+    }
+
+    @Override
+    public void run() {
+        List<Anjay> clients = new ArrayList<>();
+        try (AnjayFleet fleet = new AnjayFleet(100L)) {
+            for (int i = 0; i < this.args.fleetSize; ++i) {
+                Anjay anjay = createClient(i);
+                clients.add(anjay);
+                fleet.add(anjay);
+            }
+            Logger.getAnonymousLogger()
+                    .log(Level.INFO, "started " + clients.size() + " clients in one fleet");
+
+            Thread stdinThread =
+                    new Thread(
+                            () -> {
+                                try (BufferedReader reader =
+                                        new BufferedReader(new InputStreamReader(System.in))) {
+                                    while (reader.readLine() != null) {}
+                                } catch (IOException e) {
+                                    Logger.getAnonymousLogger()
+                                            .log(Level.WARNING, "failed to read from stdin: ", e);
+                                } finally {
+                                    fleet.interrupt();
+                                }
+                            });
+            stdinThread.start();
+            fleet.run();
+        } catch (Exception e) {
+            Logger.getAnonymousLogger().log(Level.SEVERE, "fleet demo failed: ", e);
+        } finally {
+            for (Anjay anjay : clients) {
+                anjay.close();
+            }
+        }
+    }
+}
@@ -46,7 +46,8 @@ public class Test {
             return;
         }
 
-        Thread thread = new Thread(new DemoClient(args));
+        Thread thread =
+                new Thread(args.fleetSize > 0 ? new FleetDemo(args) : new DemoClient(args));
         thread.start();
         thread.join();
     }
@@ -18,19 +18,24 @@ package com.avsystem.anjay;
 
 import com.avsystem.anjay.impl.NativeAnjay;
 import com.avsystem.anjay.impl.NativeLog;
+import java.net.InetAddress;
 import java.nio.channels.SelectableChannel;
 import java.time.Duration;
 import java.util.Arrays;
+import java.util.Collections;
 import java.util.EnumSet;
 import java.util.List;
+import java.util.Map;
 import java.util.Objects;
 import java.util.Optional;
 import java.util.Set;
+import java.util.logging.Level;
 import java.util.stream.Collectors;
 
 /** Anjay object containing all information required for LwM2M communication. */
 public final class Anjay implements AutoCloseable {
     private NativeAnjay anjay;
+    private volatile Runnable wakeupHandler;
 
     /**
      * A constant that may be used in {@link #scheduleRegistrationUpdate(int)} call instead of Short
@@ -118,6 +123,47 @@ public final class Anjay implements AutoCloseable {
          */
         public Optional<CoapUdpTxParams> udpTxParams = Optional.empty();
 
+        /**
+         * Enables measuring round-trip times of confirmable CoAP exchanges over plain UDP.
+         *
+         * <p>The resulting estimate (see {@link SocketStats#retransmissionTimeout}) is used as
+         * ACK_TIMEOUT for downloads and firmware update transfers from hosts that the client
+         * already communicates with, unless explicit transmission params are configured for them.
+         * Exchanges secured with DTLS cannot be measured.
+         *
+         * <p>Only sockets of this client are measured, starting from the moment they are first
+         * reported by {@link Anjay#getSocketEntries()}, which the event loop calls after each step.
+         */
+        public boolean adaptiveTxParams;
+
+        /**
+         * If set, {@link Anjay#notifyChanged(int, int, int)} and {@link
+         * Anjay#notifyInstancesChanged(int)} calls are collected and passed to the library at most
+         * once per this window, during {@link Anjay#schedRun()}, each distinct path only once. A
+         * change of the Instance set of an Object subsumes changes of Resources within it.
+         *
+         * <p>A zero window coalesces calls made between consecutive {@link Anjay#schedRun()} calls.
+         * Errors are only logged, as they happen after the call returns. If not set, every call is
+         * passed to the library immediately.
+         */
+        public Optional<Duration> notifyCoalescingWindow = Optional.empty();
+
+        /**
+         * Maximum random delay applied to {@link Anjay#scheduleReconnect(Set)}, {@link
+         * Anjay#scheduleRegistrationUpdate(int)} and {@link Anjay#exitOffline(Set)}, so that many
+         * clients reacting to the same event do not contact the server at the same time. See also
+         * {@link Anjay#setReconnectRateLimit(double)}.
+         *
+         * <p>Errors from delayed requests (e.g. no active server with a given SSID) cannot be
+         * reported to the caller, and are only logged. If not set, these requests are not
+         * delayed.
+         *
+         * <p>A request made while another one of the same kind is still delayed is merged into
+         * the latter, and {@link Anjay#enterOffline(Set)} cancels a delayed {@link
+         * Anjay#exitOffline(Set)} for the affected transports.
+         */
+        public Optional<Duration> reconnectJitter = Optional.empty();
+
         /**
          * Configuration of the DTLS handshake retransmission timeouts for UDP connection.
          *
@@ -197,6 +243,16 @@ public final class Anjay implements AutoCloseable {
          */
         public boolean preferHierarchicalFormats;
 
+        /**
+         * LwM2M protocol versions to attempt when registering to LwM2M Servers. LwM2M 1.1 is
+         * required for Composite operations, SenML payloads and {@link AnjaySend}.
+         *
+         * <p>If not set, only LwM2M 1.0 is used, as in earlier releases of this library. To use
+         * LwM2M 1.1 features, set the maximum version to {@link Lwm2mVersion#VERSION_1_1}, in
+         * which case the highest version accepted by the server is used.
+         */
+        public Optional<Lwm2mVersionConfig> lwm2mVersionConfig = Optional.empty();
+
         /** Enables support for DTLS connection_id extension for all DTLS connections. */
         public boolean useConnectionId;
 
@@ -388,6 +444,11 @@ public final class Anjay implements AutoCloseable {
         public final boolean queueMode;
         /** Used port. */
         public final int port;
+        /**
+         * Indicates if there is outgoing data queued on the socket, i.e. {@link
+         * Anjay#flush(SelectableChannel)} should be called once the channel becomes writable.
+         */
+        public final boolean pendingOutput;
 
         /** Constructor for SocketEntry - it is not intended to be called by user. */
         public SocketEntry(
@@ -396,14 +457,154 @@ public final class Anjay implements AutoCloseable {
                 int ssid,
                 boolean queueMode,
                 int port) {
+            this(channel, transport, ssid, queueMode, port, false);
+        }
+
+        /** Constructor for SocketEntry - it is not intended to be called by user. */
+        public SocketEntry(
+                SelectableChannel channel,
+                Transport transport,
+                int ssid,
+                boolean queueMode,
+                int port,
+                boolean pendingOutput) {
             this.channel = channel;
             this.transport = transport;
             this.ssid = ssid;
             this.queueMode = queueMode;
             this.port = port;
+            this.pendingOutput = pendingOutput;
         }
     }
 
+    /**
+     * Snapshot of traffic counters of a single socket, as returned by {@link
+     * Anjay#getSocketStats(SelectableChannel)}. All values are cumulative since the socket was
+     * created.
+     */
+    public static final class SocketStats {
+        /** Number of bytes successfully passed to the socket for sending. */
+        public final long bytesSent;
+        /** Number of bytes received. */
+        public final long bytesReceived;
+        /** Number of send calls, i.e. number of datagrams for UDP. */
+        public final long sendCalls;
+        /** Number of receive calls, including ones that timed out. */
+        public final long receiveCalls;
+        /** Number of receive calls that timed out waiting for data. */
+        public final long receiveTimeouts;
+        /** Number of times the system did not accept all data passed for sending at once. */
+        public final long sendStalls;
+        /** Total time spent waiting for the socket to become readable, writable or connected. */
+        public final Duration waitTime;
+        /** Number of failed operations, by error description. Timed out receives are excluded. */
+        public final Map<String, Long> errors;
+        /**
+         * Number of round-trip time samples, only taken if {@link
+         * Configuration#adaptiveTxParams} is enabled.
+         */
+        public final long rttSamples;
+        /** Smoothed round-trip time as per RFC 6298, or null if there are no samples. */
+        public final Duration smoothedRtt;
+        /** Round-trip time variation as per RFC 6298, or null if there are no samples. */
+        public final Duration rttVariation;
+        /** Retransmission timeout derived from the estimate, or null if there are no samples. */
+        public final Duration retransmissionTimeout;
+
+        /** Constructor for SocketStats - it is not intended to be called by user. */
+        public SocketStats(
+                long bytesSent,
+                long bytesReceived,
+                long sendCalls,
+                long receiveCalls,
+                long receiveTimeouts,
+                long sendStalls,
+                Duration waitTime,
+                Map<String, Long> errors,
+                long rttSamples,
+                Duration smoothedRtt,
+                Duration rttVariation,
+                Duration retransmissionTimeout) {
+            this.bytesSent = bytesSent;
+            this.bytesReceived = bytesReceived;
+            this.sendCalls = sendCalls;
+            this.receiveCalls = receiveCalls;
+            this.receiveTimeouts = receiveTimeouts;
+            this.sendStalls = sendStalls;
+            this.waitTime = waitTime;
+            this.errors = Collections.unmodifiableMap(errors);
+            this.rttSamples = rttSamples;
+            this.smoothedRtt = smoothedRtt;
+            this.rttVariation = rttVariation;
+            this.retransmissionTimeout = retransmissionTimeout;
+        }
+    }
+
+    /**
+     * Observation status of a Resource, as returned by {@link #getObservationStatus(int, int, int)}
+     * or passed to {@link ObservationListener}.
+     */
+    public static final class ObservationStatus {
+        /** Object ID of the Resource. */
+        public final int oid;
+        /** Object Instance ID of the Resource. */
+        public final int iid;
+        /** Resource ID of the Resource. */
+        public final int rid;
+        /** Whether any server observes the Resource. */
+        public final boolean observed;
+        /**
+         * Smallest Minimum Period (in seconds) among all observations of the Resource. Only
+         * meaningful if {@link #observed} is true.
+         */
+        public final int minPeriod;
+        /**
+         * Smallest Maximum Evaluation Period (in seconds) among all observations of the Resource,
+         * or {@link AnjayAttributes#PERIOD_NONE} if none is set. Only meaningful if {@link
+         * #observed} is true.
+         */
+        public final int maxEvalPeriod;
+
+        /** Constructor for ObservationStatus - it is not intended to be called by user. */
+        public ObservationStatus(
+                int oid, int iid, int rid, boolean observed, int minPeriod, int maxEvalPeriod) {
+            this.oid = oid;
+            this.iid = iid;
+            this.rid = rid;
+            this.observed = observed;
+            this.minPeriod = minPeriod;
+            this.maxEvalPeriod = maxEvalPeriod;
+        }
+    }
+
+    /** Listener notified about changes of observation status of watched Resources. */
+    @FunctionalInterface
+    public interface ObservationListener {
+        /**
+         * Called from {@link Anjay#serve(SelectableChannel)} or {@link Anjay#schedRun()} when a
+         * Resource watched with {@link Anjay#watchObservation(int, int, int)} starts or stops being
+         * observed, or its effective periods change. It may watch or unwatch Resources.
+         *
+         * @param status New observation status of the Resource.
+         */
+        void onObservationChanged(ObservationStatus status);
+    }
+
+    /** Function resolving host names, see {@link Anjay#setHostResolver(HostResolver, Duration)}. */
+    @FunctionalInterface
+    public interface HostResolver {
+        /**
+         * Called on a worker thread to resolve a host name. Concurrent resolutions of the same host
+         * are coalesced into a single call.
+         *
+         * @param host Host name to resolve.
+         * @return Addresses of the host. An empty array or <code>null</code> means that the host
+         *     could not be resolved.
+         * @throws Exception If the host could not be resolved.
+         */
+        InetAddress[] resolve(String host) throws Exception;
+    }
+
     /**
      * Creates a new Anjay object.
      *
@@ -411,6 +612,7 @@ public final class Anjay implements AutoCloseable {
      */
     public Anjay(Configuration config) {
         NativeLog.initialize();
+        NativeLog.syncLevels();
         this.anjay = new NativeAnjay(config);
     }
 
@@ -420,6 +622,146 @@ public final class Anjay implements AutoCloseable {
         this.anjay.close();
     }
 
+    /**
+     * Propagates levels of the <code>java.util.logging</code> loggers used by the library to the
+     * native code, so that messages those loggers would discard are not even produced.
+     *
+     * <p>Messages of a native module <code>foo</code> are logged to the <code>Anjay.foo</code>
+     * logger, whose parent is <code>Anjay</code>. Levels are synchronized whenever an {@link
+     * Anjay} object is created; this method must be called after they are changed later on.
+     *
+     * <p>A level configured for a module (e.g. with an <code>Anjay.foo.level</code> logging
+     * property) is also applied by {@link #schedRun()} once that module logs its first message.
+     * Until then, messages of the module are filtered with the level of <code>Anjay</code>.
+     */
+    public static void syncLogLevels() {
+        NativeLog.syncLevels();
+    }
+
+    /**
+     * Limits the number of stack frames logged for Java exceptions thrown from callbacks and
+     * caught by the native code. By default, 16 frames are logged.
+     *
+     * @param frames Maximum number of frames to log; 0 logs only the exception itself.
+     */
+    public static void setMaxLoggedStackFrames(int frames) {
+        NativeLog.setMaxStackFrames(frames);
+    }
+
+    /**
+     * Makes messages logged by the native code be delivered to <code>java.util.logging</code> by a
+     * background thread, instead of synchronously by the thread that logs them (usually the one
+     * calling {@link Anjay#serve} or {@link Anjay#schedRun}).
+     *
+     * <p>At most <code>maxPendingMessages</code> messages wait for delivery at a time; any more
+     * are dropped, which is reported with a warning and counted by {@link
+     * #getDroppedLogMessages()}. Calling this method again replaces the queue, delivering the
+     * messages already in it.
+     *
+     * @param maxPendingMessages Capacity of the queue of messages waiting for delivery.
+     */
+    public static void enableAsyncLogging(int maxPendingMessages) {
+        NativeLog.enableAsync(maxPendingMessages);
+    }
+
+    /** Delivers all messages still waiting in the queue and goes back to logging synchronously. */
+    public static void disableAsyncLogging() {
+        NativeLog.disableAsync();
+    }
+
+    /**
+     * Returns the number of messages dropped since asynchronous logging was last enabled with
+     * {@link #enableAsyncLogging(int)}.
+     *
+     * @return Number of dropped messages, or 0 if asynchronous logging is disabled.
+     */
+    public static long getDroppedLogMessages() {
+        return NativeLog.getDroppedMessages();
+    }
+
+    /**
+     * Makes messages logged by the native code be written to a size-capped ring file mapped into
+     * memory, instead of being passed to <code>java.util.logging</code>. Once the file is full, the
+     * oldest messages are overwritten.
+     *
+     * <p>This is meant for capturing verbose diagnostics cheaply: each message costs a copy into
+     * memory, with no JNI calls and no I/O. While the ring is enabled, <code>level</code> applies
+     * to all native modules instead of the levels of their loggers, e.g. {@link Level#FINEST
+     * FINEST} captures everything without making the loggers verbose. The levels of the loggers
+     * are restored by {@link #disableLogRing()}.
+     *
+     * <p>The file is plain text, one timestamped message per line, preceded by a 32-byte header
+     * with the magic <code>AVSLOGR1</code>, the capacity of the data area and two 64-bit counters
+     * of bytes ever written (started and completed), all in native byte order. Byte number N is
+     * stored at offset N modulo capacity of the data area. The file remains readable after a crash
+     * of the process.
+     *
+     * @param path Path of the file to create or replace. It is prepared as <code>path.tmp</code>
+     *     and then renamed, so a ring previously enabled at the same path stays intact until
+     *     replaced.
+     * @param sizeBytes Size of the file; values smaller than 4096 are rounded up.
+     * @param level Lowest level of messages to write to the file.
+     * @throws AnjayException If the file cannot be created or mapped.
+     */
+    public static void enableLogRing(String path, long sizeBytes, Level level) {
+        NativeLog.enableRing(path, sizeBytes, level);
+    }
+
+    /**
+     * Stops writing to the ring file enabled with {@link #enableLogRing(String, long, Level)}, and
+     * resumes passing messages to <code>java.util.logging</code> with the levels of the loggers.
+     * The file is left in place.
+     */
+    public static void disableLogRing() {
+        NativeLog.disableRing();
+    }
+
+    /**
+     * Returns complete lines currently stored in the ring file, oldest first. Messages may keep
+     * being logged while this method runs.
+     *
+     * @return Contents of the ring as text encoded in UTF-8.
+     * @throws IllegalStateException If the ring is not enabled.
+     */
+    public static byte[] snapshotLogRing() {
+        return NativeLog.snapshotRing();
+    }
+
+    /**
+     * Limits the rate at which reconnections and registration updates requested by all {@link
+     * Anjay} objects in the process are carried out. Requests exceeding the limit are delayed
+     * rather than rejected.
+     *
+     * <p>To spread reconnections of a fleet of <code>N</code> clients evenly over a window of
+     * <code>W</code> seconds (e.g. half of the registration lifetime), set the limit to <code>N / W
+     * </code>.
+     *
+     * <p>Note: Only requests made through {@link #scheduleReconnect(Set)}, {@link
+     * #scheduleRegistrationUpdate(int)} and {@link #exitOffline(Set)} are affected. Retries
+     * performed by the library itself after communication errors follow its own backoff policy.
+     *
+     * @param requestsPerSecond Maximum number of requests per second. Zero or less disables the
+     *     limit, which is the default.
+     */
+    public static void setReconnectRateLimit(double requestsPerSecond) {
+        NativeAnjay.setReconnectRateLimit(requestsPerSecond);
+    }
+
+    /**
+     * Replaces the function used by all {@link Anjay} objects in the process to resolve host names
+     * of servers and download URLs, e.g. with a stub in tests. Results are cached for <code>
+     * cacheTtl</code>; results cached so far are dropped.
+     *
+     * <p>By default, {@link InetAddress#getAllByName(String)} is used and results are cached for
+     * 60 seconds.
+     *
+     * @param resolver Function to use, or null to restore the default one.
+     * @param cacheTtl Time for which successful results are cached.
+     */
+    public static void setHostResolver(HostResolver resolver, Duration cacheTtl) {
+        NativeAnjay.setHostResolver(resolver, cacheTtl.toMillis());
+    }
+
     /**
      * Function returning the library version.
      *
@@ -434,6 +776,7 @@ public final class Anjay implements AutoCloseable {
      * invocation.
      */
     public void schedRun() {
+        NativeLog.syncNewModules();
         this.anjay.schedRun();
     }
 
@@ -507,6 +850,36 @@ public final class Anjay implements AutoCloseable {
         this.anjay.serve(channel);
     }
 
+    /**
+     * Writes out data queued for sending on given <code>channel</code>, as much as it is possible
+     * without blocking.
+     *
+     * <p>Stream-oriented sockets do not block when the kernel send buffer is full - the data is
+     * queued instead and {@link SocketEntry#pendingOutput} is set. This method should be called
+     * when such channel becomes writable. While more than 64 KiB is queued, further sends on the
+     * channel fail immediately instead of waiting for the queue to drain.
+     *
+     * @param channel A channel to flush.
+     * @throws Exception In case of failure.
+     */
+    public void flush(SelectableChannel channel) throws Exception {
+        this.anjay.flush(channel);
+    }
+
+    /**
+     * Retrieves traffic counters of the socket associated with given <code>channel</code>.
+     *
+     * <p>The counters are maintained natively, so this method is the only point at which they are
+     * transferred to Java.
+     *
+     * @param channel A channel to retrieve the counters of.
+     * @return Snapshot of the counters.
+     * @throws IllegalArgumentException if the channel does not belong to any known channels.
+     */
+    public SocketStats getSocketStats(SelectableChannel channel) {
+        return this.anjay.getSocketStats(channel);
+    }
+
     /**
      * Determines time of next scheduled task.
      *
@@ -761,6 +1134,220 @@ public final class Anjay implements AutoCloseable {
         this.anjay.notifyInstancesChanged(oid);
     }
 
+    /**
+     * Sets the function called when a request is posted from another thread (see e.g. {@link
+     * #postNotifyChanged(int, int, int)}) and the thread running the event loop needs to be woken
+     * up to handle it. {@link AnjayEventLoop} and {@link AnjayFleet} set it automatically; custom
+     * event loops should set it to e.g. {@link java.nio.channels.Selector#wakeup()}.
+     *
+     * @param handler Function to call, or null to disable wake-ups.
+     */
+    public void setWakeupHandler(Runnable handler) {
+        this.wakeupHandler = handler;
+    }
+
+    /**
+     * Thread-safe variant of {@link #notifyChanged(int, int, int)}. The request is queued without
+     * locking and performed during the next {@link #schedRun()} call; as long as there are queued
+     * requests, {@link #timeToNext()} returns zero.
+     *
+     * <p>Errors are only logged, as they happen after this method returns. The object MUST NOT be
+     * closed while other threads may still call this method.
+     *
+     * @param oid Object ID of the changed Resource.
+     * @param iid Object Instance ID of the changed Resource.
+     * @param rid Resource ID of the changed Resource.
+     * @throws IllegalStateException If {@link #close()} has already been called on this object.
+     */
+    public void postNotifyChanged(int oid, int iid, int rid) {
+        posted(this.anjay.postNotifyChanged(oid, iid, rid));
+    }
+
+    /**
+     * Thread-safe variant of {@link #notifyInstancesChanged(int)}. See {@link
+     * #postNotifyChanged(int, int, int)} for details.
+     *
+     * @param oid Object ID of the changed Object.
+     * @throws IllegalStateException If {@link #close()} has already been called on this object.
+     */
+    public void postNotifyInstancesChanged(int oid) {
+        posted(this.anjay.postNotifyInstancesChanged(oid));
+    }
+
+    /**
+     * Thread-safe variant of {@link #scheduleRegistrationUpdate(int)}. See {@link
+     * #postNotifyChanged(int, int, int)} for details.
+     *
+     * @param ssid Short Server ID of the server to send Update to, or {@link #SSID_ANY}.
+     * @throws IllegalStateException If {@link #close()} has already been called on this object.
+     */
+    public void postRegistrationUpdate(int ssid) {
+        posted(this.anjay.postRegistrationUpdate(ssid));
+    }
+
+    /**
+     * Thread-safe variant of {@link #enterOffline(Set)}. See {@link #postNotifyChanged(int, int,
+     * int)} for details.
+     *
+     * @param transportSet Set of transports to put into offline mode.
+     * @throws IllegalStateException If {@link #close()} has already been called on this object.
+     */
+    public void postEnterOffline(Set<Transport> transportSet) {
+        posted(this.anjay.postEnterOffline(transportSet));
+    }
+
+    /**
+     * Thread-safe variant of {@link #exitOffline(Set)}. See {@link #postNotifyChanged(int, int,
+     * int)} for details.
+     *
+     * @param transportSet Set of transports to put back into online mode.
+     * @throws IllegalStateException If {@link #close()} has already been called on this object.
+     */
+    public void postExitOffline(Set<Transport> transportSet) {
+        posted(this.anjay.postExitOffline(transportSet));
+    }
+
+    /**
+     * Reports a new sample of a numeric Resource. The sample is evaluated natively against the
+     * Greater Than, Less Than, Step and Maximum Period attributes known for the Resource, and the
+     * Resource is reported as changed (as with {@link #postNotifyChanged(int, int, int)}) only if
+     * any of them is satisfied for any server. This makes it possible to sample at high rates
+     * without every sample reaching the data model.
+     *
+     * <p>Attributes are known if they were set through {@link AnjayAttrStorage}, written to an
+     * Object that implements {@link AnjayObjectAttrHandlers}, or set with {@link
+     * #setSampleAttributes(int, int, int, int, AnjayAttributes.ResourceAttrs)}. Attributes written
+     * by a server into {@link AnjayAttrStorage} are not visible to this method, so attributes set
+     * through {@link AnjayAttrStorage} are ignored as soon as the storage is found modified after
+     * {@link #serve(SelectableChannel)} (see {@link AnjayAttrStorage#isModified()}), or after it is
+     * restored, until it is purged. If no attributes are known, every change of the value is
+     * reported.
+     *
+     * <p>The Object's read handler MUST return the latest sample, as the library reads the value
+     * when it sends a notification. This method may be called from any thread.
+     *
+     * @param oid Object ID of the sampled Resource.
+     * @param iid Object Instance ID of the sampled Resource.
+     * @param rid Resource ID of the sampled Resource.
+     * @param value Sampled value.
+     * @param timestampNanos Time at which the sample was taken, as returned by {@link
+     *     System#nanoTime()}.
+     * @throws IllegalArgumentException If any of the IDs is not representable as a 16-bit unsigned
+     *     integer.
+     * @throws IllegalStateException If {@link #close()} has already been called on this object.
+     */
+    public void ingestSample(int oid, int iid, int rid, double value, long timestampNanos) {
+        posted(this.anjay.ingestSample(oid, iid, rid, value, timestampNanos));
+    }
+
+    /**
+     * Overload of {@link #ingestSample(int, int, int, double, long)} that uses the current time as
+     * the timestamp.
+     */
+    public void ingestSample(int oid, int iid, int rid, double value) {
+        this.ingestSample(oid, iid, rid, value, System.nanoTime());
+    }
+
+    /**
+     * Sets attributes used by {@link #ingestSample(int, int, int, double, long)} to evaluate
+     * samples of a given Resource on behalf of a given server. These do not affect the attributes
+     * used by the library itself.
+     *
+     * @param ssid Short Server ID of the server the attributes apply to.
+     * @param oid Object ID of the sampled Resource.
+     * @param iid Object Instance ID of the sampled Resource.
+     * @param rid Resource ID of the sampled Resource.
+     * @param attrs Attributes to use, or null to forget them.
+     * @throws IllegalArgumentException If any of the IDs is not representable as a 16-bit unsigned
+     *     integer.
+     * @throws IllegalStateException If {@link #close()} has already been called on this object.
+     */
+    public void setSampleAttributes(
+            int ssid, int oid, int iid, int rid, AnjayAttributes.ResourceAttrs attrs) {
+        this.anjay.setSampleAttributes(ssid, oid, iid, rid, attrs);
+    }
+
+    /**
+     * Queries whether any server observes a given Resource. This is a cheap native call, but to
+     * avoid polling, consider {@link #watchObservation(int, int, int)} instead.
+     *
+     * @param oid Object ID of the Resource.
+     * @param iid Object Instance ID of the Resource.
+     * @param rid Resource ID of the Resource.
+     * @return Current observation status of the Resource.
+     * @throws IllegalArgumentException If any of the IDs is not representable as a 16-bit unsigned
+     *     integer.
+     * @throws IllegalStateException If {@link #close()} has already been called on this object.
+     */
+    public ObservationStatus getObservationStatus(int oid, int iid, int rid) {
+        return this.anjay.getObservationStatus(oid, iid, rid);
+    }
+
+    /**
+     * Returns the Resources watched with {@link #watchObservation(int, int, int)} that are
+     * currently observed by any server, as of the last {@link #serve(SelectableChannel)} or {@link
+     * #schedRun()} call.
+     *
+     * @return List of statuses of observed Resources.
+     * @throws IllegalStateException If {@link #close()} has already been called on this object.
+     */
+    public List<ObservationStatus> getObservedResources() {
+        return this.anjay.getObservedResources();
+    }
+
+    /**
+     * Starts tracking observation status of a given Resource. Whenever it changes, the listener set
+     * with {@link #setObservationListener(ObservationListener)} is called, so that e.g. sensor code
+     * may only take measurements of Resources that someone observes.
+     *
+     * <p>Status of watched Resources is re-checked natively after each {@link
+     * #serve(SelectableChannel)} and {@link #schedRun()} call, which is where observations may be
+     * established or cancelled. The listener is never called from within this method; the status
+     * at the time of the call is taken as the initial one, and may be queried with {@link
+     * #getObservationStatus(int, int, int)}. Watching an already watched Resource does nothing.
+     *
+     * @param oid Object ID of the Resource.
+     * @param iid Object Instance ID of the Resource.
+     * @param rid Resource ID of the Resource.
+     * @throws IllegalArgumentException If any of the IDs is not representable as a 16-bit unsigned
+     *     integer.
+     * @throws IllegalStateException If {@link #close()} has already been called on this object.
+     */
+    public void watchObservation(int oid, int iid, int rid) {
+        this.anjay.watchObservation(oid, iid, rid);
+    }
+
+    /**
+     * Stops tracking observation status of a given Resource.
+     *
+     * @param oid Object ID of the Resource.
+     * @param iid Object Instance ID of the Resource.
+     * @param rid Resource ID of the Resource.
+     * @throws IllegalArgumentException If any of the IDs is not representable as a 16-bit unsigned
+     *     integer.
+     * @throws IllegalStateException If {@link #close()} has already been called on this object.
+     */
+    public void unwatchObservation(int oid, int iid, int rid) {
+        this.anjay.unwatchObservation(oid, iid, rid);
+    }
+
+    /**
+     * Sets the listener notified about observation status changes of watched Resources.
+     *
+     * @param listener Listener to set, or null to remove it.
+     * @throws IllegalStateException If {@link #close()} has already been called on this object.
+     */
+    public void setObservationListener(ObservationListener listener) {
+        this.anjay.setObservationListener(listener);
+    }
+
+    private void posted(boolean wakeupNeeded) {
+        Runnable handler = this.wakeupHandler;
+        if (wakeupNeeded && handler != null) {
+            handler.run();
+        }
+    }
+
     /**
      * Registers the Object in the data model, making it available for RPC calls.
      *
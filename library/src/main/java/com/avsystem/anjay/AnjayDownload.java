@@ -112,7 +112,8 @@ public final class AnjayDownload {
      * @param config Download configuration.
      * @param handlers Implementation of handlers to be called by downloader.
      * @return {@link AnjayDownload} object which may be used to abort the download process.
-     * @throws Exception If config is invalid or download can't be started.
+     * @throws Exception If config is invalid, handlers implement neither <code>onNextBlock</code>
+     *     overload or download can't be started.
      * @throws ConcurrentModificationException if the security configuration used {@link
      *     AnjaySecurityConfigFromDm} and the configuration expired due to {@link Anjay#serve} or
      *     {@link Anjay#schedRun} calls happening in between.
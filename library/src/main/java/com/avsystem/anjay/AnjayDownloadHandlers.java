@@ -18,19 +18,52 @@ package com.avsystem.anjay;
 
 import com.avsystem.anjay.AnjayDownload.Result;
 import com.avsystem.anjay.AnjayDownload.ResultDetails;
+import java.nio.ByteBuffer;
 import java.util.Optional;
 
-/** Interface specifying handlers to be called during download. */
+/**
+ * Interface specifying handlers to be called during download.
+ *
+ * <p>Implementations <strong>MUST</strong> override one of the <code>onNextBlock</code>
+ * overloads, otherwise {@link AnjayDownload#startDownload} throws {@link
+ * IllegalArgumentException}. If both are overridden, only {@link #onNextBlock(ByteBuffer,
+ * Optional)} is called.
+ */
 public interface AnjayDownloadHandlers {
     /**
      * Called after receiving a chunk of data from remote server.
      *
+     * <p>The default implementation copies the data into a new array and calls {@link
+     * #onNextBlock(byte[], Optional)}. Override this method instead to process the data without
+     * copying it.
+     *
+     * @param data Read-only view of the received chunk of data. It refers directly to the native
+     *     download buffer, so it <strong>MUST NOT</strong> be used after this method returns.
+     * @param etag ETag of the data. The same array is passed for subsequent chunks as long as the
+     *     ETag does not change; it <strong>MUST NOT</strong> be modified.
+     * @throws Exception If an error occurred, in which case the download will be terminated with
+     *     {@link Result#FAILED FAILED} result.
+     */
+    default void onNextBlock(ByteBuffer data, Optional<byte[]> etag) throws Exception {
+        byte[] array = new byte[data.remaining()];
+        data.get(array);
+        onNextBlock(array, etag);
+    }
+
+    /**
+     * Called after receiving a chunk of data from remote server, if {@link
+     * #onNextBlock(ByteBuffer, Optional)} is not overridden.
+     *
      * @param data Received chunk of data.
-     * @param etag ETag of the data.
+     * @param etag ETag of the data. It <strong>MUST NOT</strong> be modified.
      * @throws Exception If an error occurred, in which case the download will be terminated with
      *     {@link Result#FAILED FAILED} result.
      */
-    void onNextBlock(byte[] data, Optional<byte[]> etag) throws Exception;
+    default void onNextBlock(byte[] data, Optional<byte[]> etag) throws Exception {
+        // Not reached, as AnjayDownload.startDownload() rejects handlers overriding neither
+        // overload.
+        throw new UnsupportedOperationException("onNextBlock is not implemented");
+    }
 
     /**
      * Called after the download is finished or aborted.
@@ -31,6 +31,7 @@ import java.util.concurrent.PriorityBlockingQueue;
 import java.util.function.Consumer;
 import java.util.logging.Level;
 import java.util.logging.Logger;
+import java.util.stream.Collectors;
 
 /**
  * This is a standard Anjay event loop. In many cases it might be sufficient to build its more
@@ -85,11 +86,13 @@ public final class AnjayEventLoop implements Closeable {
         this.anjay = anjay;
         this.maxWaitTime = maxWaitTime;
         eventLoopSelector = Selector.open();
+        anjay.setWakeupHandler(eventLoopSelector::wakeup);
     }
 
     /**
      * Calls {@link Selector#select(long)} on all sockets currently in use and then {@link
-     * Anjay#serve(SelectableChannel)} if appropriate.
+     * Anjay#flush(SelectableChannel)} and/or {@link Anjay#serve(SelectableChannel)} if
+     * appropriate.
      *
      * <p>This is intended as a building block for custom event loops.
      *
@@ -97,16 +100,25 @@ public final class AnjayEventLoop implements Closeable {
      * @throws IOException thrown by {@link Selector#select(long)} or {@link Selector#selectNow()}.
      */
     public synchronized void serveAny() throws IOException {
-        List<SelectableChannel> sockets = anjay.getSockets();
+        List<Anjay.SocketEntry> entries = anjay.getSocketEntries();
+        List<SelectableChannel> sockets =
+                entries.stream().map(entry -> entry.channel).collect(Collectors.toList());
 
         for (SelectionKey key : eventLoopSelector.keys()) {
             if (!sockets.contains(key.channel())) {
                 key.cancel();
             }
         }
-        for (SelectableChannel socket : sockets) {
-            if (socket.keyFor(eventLoopSelector) == null) {
-                socket.register(eventLoopSelector, SelectionKey.OP_READ);
+        for (Anjay.SocketEntry entry : entries) {
+            int ops = SelectionKey.OP_READ;
+            if (entry.pendingOutput) {
+                ops |= SelectionKey.OP_WRITE;
+            }
+            SelectionKey key = entry.channel.keyFor(eventLoopSelector);
+            if (key == null) {
+                entry.channel.register(eventLoopSelector, ops);
+            } else if (key.interestOps() != ops) {
+                key.interestOps(ops);
             }
         }
 
@@ -125,12 +137,22 @@ public final class AnjayEventLoop implements Closeable {
         }
         for (Iterator<SelectionKey> it = eventLoopSelector.selectedKeys().iterator();
                 it.hasNext(); ) {
-            try {
-                anjay.serve(it.next().channel());
-            } catch (Throwable t) {
-                Logger.getAnonymousLogger().log(Level.WARNING, "Anjay::serve() failed");
-            }
+            SelectionKey key = it.next();
             it.remove();
+            if (key.isValid() && key.isWritable()) {
+                try {
+                    anjay.flush(key.channel());
+                } catch (Throwable t) {
+                    Logger.getAnonymousLogger().log(Level.WARNING, "Anjay::flush() failed");
+                }
+            }
+            if (key.isValid() && key.isReadable()) {
+                try {
+                    anjay.serve(key.channel());
+                } catch (Throwable t) {
+                    Logger.getAnonymousLogger().log(Level.WARNING, "Anjay::serve() failed");
+                }
+            }
         }
     }
 
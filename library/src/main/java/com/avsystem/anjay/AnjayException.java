@@ -17,6 +17,7 @@
 package com.avsystem.anjay;
 
 import com.avsystem.anjay.impl.NativeAnjay;
+import java.util.concurrent.ConcurrentHashMap;
 
 /**
  * An exception that encapsulates any error condition reported by the underlying native Anjay
@@ -41,6 +42,10 @@ public class AnjayException extends RuntimeException {
     public static final int NOT_IMPLEMENTED = NativeAnjay.getErrorNotImplemented();
     public static final int SERVICE_UNAVAILABLE = NativeAnjay.getErrorServiceUnavailable();
 
+    private static final int MAX_CACHED_EXCEPTIONS = 64;
+    private static final ConcurrentHashMap<Integer, AnjayException> CACHED_EXCEPTIONS =
+            new ConcurrentHashMap<>();
+
     private final int errorCode;
 
     /**
@@ -56,6 +61,34 @@ public class AnjayException extends RuntimeException {
         this.errorCode = errorCode;
     }
 
+    private AnjayException(int errorCode) {
+        super("error code: " + errorCode, null, false, false);
+        this.errorCode = errorCode;
+    }
+
+    /**
+     * Returns an exception to be thrown from callback interfaces to report an error condition that
+     * is an expected outcome rather than a failure, e.g. {@link #NOT_FOUND} for a path a server
+     * asked about.
+     *
+     * <p>The returned object carries no stack trace and is shared between all callers that use the
+     * same error code, so throwing it costs no more than returning the code would.
+     *
+     * @param errorCode Error code to pass into the native library, usually one of the constants
+     *     defined in this class.
+     * @return Exception corresponding to the error code.
+     */
+    public static AnjayException of(int errorCode) {
+        AnjayException result = CACHED_EXCEPTIONS.get(errorCode);
+        if (result == null) {
+            result = new AnjayException(errorCode);
+            if (CACHED_EXCEPTIONS.size() < MAX_CACHED_EXCEPTIONS) {
+                CACHED_EXCEPTIONS.putIfAbsent(errorCode, result);
+            }
+        }
+        return result;
+    }
+
     /**
      * Retrieves the error code corresponding to a return value of a C function.
      *
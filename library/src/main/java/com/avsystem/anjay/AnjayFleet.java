@@ -0,0 +1,360 @@
+/*
+ * Copyright 2020-2024 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package com.avsystem.anjay;
+
+import java.io.Closeable;
+import java.io.IOException;
+import java.nio.channels.CancelledKeyException;
+import java.nio.channels.ClosedChannelException;
+import java.nio.channels.SelectableChannel;
+import java.nio.channels.SelectionKey;
+import java.nio.channels.Selector;
+import java.time.Duration;
+import java.time.Instant;
+import java.util.ArrayList;
+import java.util.Collections;
+import java.util.IdentityHashMap;
+import java.util.Iterator;
+import java.util.LinkedHashSet;
+import java.util.List;
+import java.util.Map;
+import java.util.Optional;
+import java.util.PriorityQueue;
+import java.util.Set;
+import java.util.concurrent.ConcurrentLinkedQueue;
+import java.util.function.Consumer;
+import java.util.logging.Level;
+import java.util.logging.Logger;
+
+/**
+ * Event loop serving many {@link Anjay} objects on a single thread and a single {@link Selector}.
+ *
+ * <p>It is intended for cases such as load-testing a server with a large number of simulated
+ * endpoints, where running a separate {@link AnjayEventLoop} for each of them is not feasible.
+ * Unlike {@link AnjayEventLoop}, it only queries a client for its sockets and scheduler state
+ * after that client has actually done something, so idle clients do not cost anything per loop
+ * iteration.
+ *
+ * <p>{@link Anjay} objects are not thread-safe. Once a client is added to the fleet, it shall only
+ * be accessed from within {@link AnjayFleet#execute(Anjay, Consumer)}, or through its
+ * thread-safe <code>post*</code> methods, such as {@link Anjay#postNotifyChanged(int, int, int)}.
+ * To spread the load over several cores, create several fleets, each run on its own thread.
+ *
+ * <p>Each client still owns its buffers and message cache, so when running many of them, consider
+ * lowering {@link Anjay.Configuration#inBufferSize}, {@link Anjay.Configuration#outBufferSize}
+ * and {@link Anjay.Configuration#msgCacheSize}. A failure of one client is logged and does not
+ * affect the others.
+ */
+public final class AnjayFleet implements Closeable {
+    private static final class Member {
+        private final Anjay anjay;
+        private List<SelectableChannel> channels = Collections.emptyList();
+        // Incremented whenever the scheduler deadline is recalculated, so that stale
+        // entries in the deadlines queue can be recognized.
+        private long generation;
+        private boolean removed;
+
+        private Member(Anjay anjay) {
+            this.anjay = anjay;
+        }
+    }
+
+    private static final class Deadline implements Comparable<Deadline> {
+        private final Instant time;
+        private final Member member;
+        private final long generation;
+
+        private Deadline(Instant time, Member member) {
+            this.time = time;
+            this.member = member;
+            this.generation = member.generation;
+        }
+
+        private boolean isStale() {
+            return member.removed || generation != member.generation;
+        }
+
+        @Override
+        public int compareTo(Deadline deadline) {
+            return time.compareTo(deadline.time);
+        }
+    }
+
+    private final long maxWaitTime;
+    private final Selector selector;
+    // Accessed only by the loop thread.
+    private final Map<Anjay, Member> members = new IdentityHashMap<>();
+    private final PriorityQueue<Deadline> deadlines = new PriorityQueue<>();
+    // Clients whose sockets could not be registered because their keys were cancelled, but not
+    // yet deregistered by the selector.
+    private final Set<Member> needsRefresh = new LinkedHashSet<>();
+    private final ConcurrentLinkedQueue<Runnable> pendingTasks = new ConcurrentLinkedQueue<>();
+    private volatile Thread thread;
+
+    /**
+     * @param maxWaitTime Maximum time (in milliseconds) to spend in each call to {@link
+     *     Selector#select(long)}. Tasks submitted from other threads wake the loop up immediately,
+     *     so this only bounds the latency of {@link AnjayFleet#interrupt()}.
+     * @throws IllegalArgumentException if the timeout is negative
+     * @throws IOException thrown by {@link Selector#open()}
+     */
+    public AnjayFleet(long maxWaitTime) throws IOException {
+        if (maxWaitTime < 0L) {
+            throw new IllegalArgumentException("Maximum wait time must be non-negative");
+        }
+
+        this.maxWaitTime = maxWaitTime;
+        this.selector = Selector.open();
+    }
+
+    /**
+     * Adds a client to the fleet. It will be served starting with the next loop iteration.
+     *
+     * @param anjay Client to add. It MUST NOT be used outside of the fleet afterwards.
+     */
+    public void add(Anjay anjay) {
+        submit(
+                () -> {
+                    if (!members.containsKey(anjay)) {
+                        Member member = new Member(anjay);
+                        members.put(anjay, member);
+                        anjay.setWakeupHandler(() -> execute(anjay, client -> {}));
+                        refresh(member);
+                    }
+                });
+    }
+
+    /**
+     * Removes a client from the fleet. The client is not closed.
+     *
+     * @param anjay Client to remove.
+     */
+    public void remove(Anjay anjay) {
+        submit(
+                () -> {
+                    Member member = members.remove(anjay);
+                    if (member != null) {
+                        anjay.setWakeupHandler(null);
+                        member.removed = true;
+                        for (SelectableChannel channel : member.channels) {
+                            cancel(channel);
+                        }
+                    }
+                });
+    }
+
+    /**
+     * Runs an action on a client from the loop thread, e.g. to call {@link
+     * Anjay#scheduleRegistrationUpdate(int)} or {@link Anjay#notifyChanged(int, int, int)}.
+     *
+     * @param anjay Client to run the action on. It MUST have been added to the fleet.
+     * @param action Action to run.
+     */
+    public void execute(Anjay anjay, Consumer<Anjay> action) {
+        submit(
+                () -> {
+                    Member member = members.get(anjay);
+                    if (member == null) {
+                        throw new IllegalArgumentException("Anjay object is not in the fleet");
+                    }
+                    action.accept(anjay);
+                    refresh(member);
+                });
+    }
+
+    /** @return Number of clients currently in the fleet. Only accurate on the loop thread. */
+    public int size() {
+        return members.size();
+    }
+
+    /**
+     * Runs a single iteration of the loop: runs submitted tasks, waits for socket activity or the
+     * nearest scheduler job, and then serves all the clients that need it.
+     *
+     * @throws IOException thrown by {@link Selector#select(long)} or {@link Selector#selectNow()}.
+     */
+    public synchronized void runOnce() throws IOException {
+        for (Runnable task; (task = pendingTasks.poll()) != null; ) {
+            try {
+                task.run();
+            } catch (Throwable t) {
+                Logger.getAnonymousLogger().log(Level.WARNING, "AnjayFleet task failed", t);
+            }
+        }
+
+        long waitTimeMs = maxWaitTime;
+        Deadline nearest = nearestDeadline();
+        if (nearest != null) {
+            waitTimeMs =
+                    Math.min(waitTimeMs, Duration.between(Instant.now(), nearest.time).toMillis());
+        }
+        if (waitTimeMs <= 0) {
+            selector.selectNow();
+        } else {
+            selector.select(waitTimeMs);
+        }
+
+        Set<Member> touched = new LinkedHashSet<>(needsRefresh);
+        needsRefresh.clear();
+        for (Iterator<SelectionKey> it = selector.selectedKeys().iterator(); it.hasNext(); ) {
+            SelectionKey key = it.next();
+            it.remove();
+            Member member = (Member) key.attachment();
+            if (member.removed) {
+                continue;
+            }
+            if (key.isValid() && key.isWritable()) {
+                try {
+                    member.anjay.flush(key.channel());
+                } catch (Throwable t) {
+                    Logger.getAnonymousLogger().log(Level.WARNING, "Anjay::flush() failed", t);
+                }
+            }
+            if (key.isValid() && key.isReadable()) {
+                try {
+                    member.anjay.serve(key.channel());
+                } catch (Throwable t) {
+                    Logger.getAnonymousLogger().log(Level.WARNING, "Anjay::serve() failed", t);
+                }
+            }
+            touched.add(member);
+        }
+
+        Instant now = Instant.now();
+        for (Deadline deadline = nearestDeadline();
+                deadline != null && !deadline.time.isAfter(now);
+                deadline = nearestDeadline()) {
+            deadlines.poll();
+            try {
+                deadline.member.anjay.schedRun();
+            } catch (Throwable t) {
+                Logger.getAnonymousLogger().log(Level.WARNING, "Anjay::schedRun() failed", t);
+            }
+            touched.add(deadline.member);
+        }
+
+        for (Member member : touched) {
+            refresh(member);
+        }
+    }
+
+    /**
+     * Runs the loop until the thread running it is interrupted (e.g. by {@link
+     * AnjayFleet#interrupt()}) or a fatal error occurs in the loop itself.
+     *
+     * @throws IOException thrown by {@link AnjayFleet#runOnce()}.
+     */
+    public synchronized void run() throws IOException {
+        thread = Thread.currentThread();
+
+        try {
+            while (!thread.isInterrupted()) {
+                runOnce();
+            }
+        } finally {
+            thread = null;
+        }
+    }
+
+    /**
+     * Interrupts the thread on which the loop is running.
+     *
+     * @throws IllegalStateException if the loop is not running
+     */
+    public void interrupt() {
+        Thread fleetThread = thread;
+        if (fleetThread == null) {
+            throw new IllegalStateException();
+        } else {
+            fleetThread.interrupt();
+        }
+    }
+
+    @Override
+    public void close() throws IOException {
+        selector.close();
+    }
+
+    private void submit(Runnable task) {
+        pendingTasks.add(task);
+        selector.wakeup();
+    }
+
+    private Deadline nearestDeadline() {
+        while (!deadlines.isEmpty() && deadlines.peek().isStale()) {
+            deadlines.poll();
+        }
+        return deadlines.peek();
+    }
+
+    private void cancel(SelectableChannel channel) {
+        SelectionKey key = channel.keyFor(selector);
+        if (key != null) {
+            key.cancel();
+        }
+    }
+
+    private void refresh(Member member) {
+        if (member.removed) {
+            return;
+        }
+        try {
+            updateChannels(member, member.anjay.getSocketEntries());
+        } catch (Throwable t) {
+            Logger.getAnonymousLogger().log(Level.WARNING, "Anjay::getSocketEntries() failed", t);
+        }
+
+        ++member.generation;
+        try {
+            Optional<Duration> timeToNext = member.anjay.timeToNext();
+            if (timeToNext.isPresent()) {
+                deadlines.add(new Deadline(Instant.now().plus(timeToNext.get()), member));
+            }
+        } catch (Throwable t) {
+            Logger.getAnonymousLogger().log(Level.WARNING, "Anjay::timeToNext() failed", t);
+        }
+    }
+
+    private void updateChannels(Member member, List<Anjay.SocketEntry> entries) {
+        List<SelectableChannel> channels = new ArrayList<>(entries.size());
+        for (Anjay.SocketEntry entry : entries) {
+            int ops = SelectionKey.OP_READ;
+            if (entry.pendingOutput) {
+                ops |= SelectionKey.OP_WRITE;
+            }
+            SelectionKey key = entry.channel.keyFor(selector);
+            try {
+                if (key == null || !key.isValid()) {
+                    entry.channel.register(selector, ops, member);
+                } else if (key.interestOps() != ops) {
+                    key.interestOps(ops);
+                }
+                channels.add(entry.channel);
+            } catch (CancelledKeyException e) {
+                needsRefresh.add(member);
+            } catch (ClosedChannelException e) {
+                Logger.getAnonymousLogger().log(Level.WARNING, "Socket closed unexpectedly");
+            }
+        }
+        for (SelectableChannel channel : member.channels) {
+            if (!channels.contains(channel)) {
+                cancel(channel);
+            }
+        }
+        member.channels = channels;
+    }
+}
@@ -148,7 +148,7 @@ public interface AnjayObject {
      *     the device will respond with an unspecified (but valid) error code.
      */
     default void instanceReset(int iid) throws Exception {
-        throw new UnsupportedOperationException("instanceReset is not implemented");
+        throw new NotImplementedException("instanceReset is not implemented");
     }
 
     /**
@@ -164,7 +164,7 @@ public interface AnjayObject {
      *     the device will respond with an unspecified (but valid) error code.
      */
     default void instanceCreate(int iid) throws Exception {
-        throw new UnsupportedOperationException("instanceCreate is not implemented");
+        throw new NotImplementedException("instanceCreate is not implemented");
     }
 
     /**
@@ -179,7 +179,7 @@ public interface AnjayObject {
      *     the device will respond with an unspecified (but valid) error code.
      */
     default void instanceRemove(int iid) throws Exception {
-        throw new UnsupportedOperationException("instanceRemove is not implemented");
+        throw new NotImplementedException("instanceRemove is not implemented");
     }
 
     /**
@@ -210,7 +210,7 @@ public interface AnjayObject {
      *     the device will respond with an unspecified (but valid) error code.
      */
     default void resourceRead(int iid, int rid, AnjayOutputContext context) throws Exception {
-        throw new UnsupportedOperationException("resourceRead on Resource is not implemented");
+        throw new NotImplementedException("resourceRead on Resource is not implemented");
     }
 
     /**
@@ -232,8 +232,7 @@ public interface AnjayObject {
      */
     default void resourceRead(int iid, int rid, int riid, AnjayOutputContext context)
             throws Exception {
-        throw new UnsupportedOperationException(
-                "resourceRead on Resource Instance is not implemented");
+        throw new NotImplementedException("resourceRead on Resource Instance is not implemented");
     }
 
     /**
@@ -252,7 +251,7 @@ public interface AnjayObject {
      *     the device will respond with an unspecified (but valid) error code.
      */
     default void resourceWrite(int iid, int rid, AnjayInputContext context) throws Exception {
-        throw new UnsupportedOperationException("resourceWrite on Resource is not implemented");
+        throw new NotImplementedException("resourceWrite on Resource is not implemented");
     }
 
     /**
@@ -275,8 +274,7 @@ public interface AnjayObject {
      */
     default void resourceWrite(int iid, int rid, int riid, AnjayInputContext context)
             throws Exception {
-        throw new UnsupportedOperationException(
-                "resourceWrite on Resource Instance is not implemented");
+        throw new NotImplementedException("resourceWrite on Resource Instance is not implemented");
     }
 
     /**
@@ -294,7 +292,7 @@ public interface AnjayObject {
      */
     default void resourceExecute(int iid, int rid, Map<Integer, Optional<String>> args)
             throws Exception {
-        throw new UnsupportedOperationException("resourceExecute is not implemented");
+        throw new NotImplementedException("resourceExecute is not implemented");
     }
 
     /**
@@ -316,7 +314,7 @@ public interface AnjayObject {
      *     the device will respond with an unspecified (but valid) error code.
      */
     default void resourceReset(int iid, int rid) throws Exception {
-        throw new UnsupportedOperationException("resourceReset is not implemented");
+        throw new NotImplementedException("resourceReset is not implemented");
     }
 
     /**
@@ -364,7 +362,7 @@ public interface AnjayObject {
      *     the device will respond with an unspecified (but valid) error code.
      */
     default void transactionBegin() throws Exception {
-        throw new UnsupportedOperationException("transactionBegin is not implemented");
+        throw new NotImplementedException("transactionBegin is not implemented");
     }
 
     /**
@@ -385,7 +383,7 @@ public interface AnjayObject {
      *     the device will respond with an unspecified (but valid) error code.
      */
     default void transactionValidate() throws Exception {
-        throw new UnsupportedOperationException("transactionValidate is not implemented");
+        throw new NotImplementedException("transactionValidate is not implemented");
     }
 
     /**
@@ -402,7 +400,7 @@ public interface AnjayObject {
      *     the device will respond with an unspecified (but valid) error code.
      */
     default void transactionCommit() throws Exception {
-        throw new UnsupportedOperationException("transcationCommit is not implemented");
+        throw new NotImplementedException("transcationCommit is not implemented");
     }
 
     /**
@@ -412,6 +410,6 @@ public interface AnjayObject {
      * @throws Exception In case of error.
      */
     default void transactionRollback() throws Exception {
-        throw new UnsupportedOperationException("transactionRollback is not implemented");
+        throw new NotImplementedException("transactionRollback is not implemented");
     }
 }
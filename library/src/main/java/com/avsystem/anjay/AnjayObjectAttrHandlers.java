@@ -37,7 +37,7 @@ public interface AnjayObjectAttrHandlers {
      *     the device will respond with an unspecified (but valid) error code.
      */
     default ObjectInstanceAttrs objectReadDefaultAttrs(int ssid) throws Exception {
-        throw new UnsupportedOperationException("objectReadDefaultAttrs is not implemented");
+        throw new NotImplementedException("objectReadDefaultAttrs is not implemented");
     }
 
     /**
@@ -50,7 +50,7 @@ public interface AnjayObjectAttrHandlers {
      *     the device will respond with an unspecified (but valid) error code.
      */
     default void objectWriteDefaultAttrs(int ssid, ObjectInstanceAttrs attrs) throws Exception {
-        throw new UnsupportedOperationException("objectWriteDefaultAttrs is not implemented");
+        throw new NotImplementedException("objectWriteDefaultAttrs is not implemented");
     }
 
     /**
@@ -64,7 +64,7 @@ public interface AnjayObjectAttrHandlers {
      *     the device will respond with an unspecified (but valid) error code.
      */
     default ObjectInstanceAttrs instanceReadDefaultAttrs(int iid, int ssid) throws Exception {
-        throw new UnsupportedOperationException("instanceReadDefaultAttrs is not implemented");
+        throw new NotImplementedException("instanceReadDefaultAttrs is not implemented");
     }
 
     /**
@@ -79,7 +79,7 @@ public interface AnjayObjectAttrHandlers {
      */
     default void instanceWriteDefaultAttrs(int iid, int ssid, ObjectInstanceAttrs attrs)
             throws Exception {
-        throw new UnsupportedOperationException("instanceWriteDefaultAttrs is not implemented");
+        throw new NotImplementedException("instanceWriteDefaultAttrs is not implemented");
     }
 
     /**
@@ -94,7 +94,7 @@ public interface AnjayObjectAttrHandlers {
      *     the device will respond with an unspecified (but valid) error code.
      */
     default ResourceAttrs resourceReadAttrs(int iid, int rid, int ssid) throws Exception {
-        throw new UnsupportedOperationException("resourceReadAttrs is not implemented");
+        throw new NotImplementedException("resourceReadAttrs is not implemented");
     }
 
     /**
@@ -110,6 +110,6 @@ public interface AnjayObjectAttrHandlers {
      */
     default void resourceWriteAttrs(int iid, int rid, int ssid, ResourceAttrs attrs)
             throws Exception {
-        throw new UnsupportedOperationException("resourceWriteAttrs is not implemented");
+        throw new NotImplementedException("resourceWriteAttrs is not implemented");
     }
 }
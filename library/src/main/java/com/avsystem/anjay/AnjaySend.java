@@ -0,0 +1,170 @@
+/*
+ * Copyright 2020-2024 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package com.avsystem.anjay;
+
+import com.avsystem.anjay.impl.NativeAnjaySend;
+import java.time.Duration;
+import java.util.Optional;
+
+/**
+ * Collects timestamped Resource values into batches delivered to a server with the LwM2M Send
+ * operation.
+ *
+ * <p>Samples are accumulated natively, without any upcalls, and a batch is sent as soon as it
+ * reaches {@link Configuration#maxSamples}, once {@link Configuration#maxDelay} passes since its
+ * first sample was added, or when {@link #flush} is called. Requests are sent by {@link
+ * Anjay#schedRun} and {@link Anjay#serve}, and their outcome is reported asynchronously through
+ * {@link AnjaySendHandlers#onSendFinished}. If the server is not reachable at the time, the
+ * batch is kept until the connection is restored.
+ *
+ * <p>Requires LwM2M 1.1 to be negotiated with the server, which has to be allowed in {@link
+ * Anjay.Configuration#lwm2mVersionConfig}. All methods must be called from the thread that runs
+ * the Anjay event loop.
+ */
+public final class AnjaySend implements AutoCloseable {
+
+    /** Configuration for {@link AnjaySend}. */
+    public static final class Configuration {
+        /** Short Server ID of the server to send data to. Required. */
+        public int ssid;
+
+        /** Number of samples after which the batch is sent. */
+        public int maxSamples = 64;
+
+        /**
+         * Maximum time between adding the first sample to a batch and sending it. If empty,
+         * batches are sent only when full or when {@link AnjaySend#flush} is called.
+         */
+        public Optional<Duration> maxDelay = Optional.empty();
+    }
+
+    /** Result of delivering a batch. */
+    public static enum Result {
+        /** Server acknowledged the Send request. */
+        SUCCESS,
+        /** Server did not respond within the CoAP exchange lifetime. */
+        TIMEOUT,
+        /** Request was aborted, e.g. because Anjay was shut down. */
+        ABORTED,
+        /** Deferred request could not be sent after the connection was restored. */
+        DEFERRED_ERROR,
+        /** Server responded with an error; the CoAP code is passed as details. */
+        REJECTED,
+        /**
+         * Request could not be sent at all, e.g. the server does not support LwM2M 1.1 or the
+         * client is bootstrapping; the Anjay error code is passed as details.
+         */
+        FAILED
+    };
+
+    private final NativeAnjaySend send;
+
+    private AnjaySend(Anjay anjay, Configuration config, AnjaySendHandlers handlers)
+            throws Exception {
+        this.send = new NativeAnjaySend(anjay, config, handlers);
+    }
+
+    /**
+     * Creates a new batch sender.
+     *
+     * @param anjay Anjay instance to send data with.
+     * @param config Sender configuration.
+     * @param handlers Handlers notified about delivery results.
+     * @return {@link AnjaySend} object.
+     * @throws Exception If config is invalid.
+     */
+    public static AnjaySend create(Anjay anjay, Configuration config, AnjaySendHandlers handlers)
+            throws Exception {
+        return new AnjaySend(anjay, config, handlers);
+    }
+
+    /**
+     * Adds an integer sample to the current batch.
+     *
+     * @param oid Object ID.
+     * @param iid Object Instance ID.
+     * @param rid Resource ID.
+     * @param value Sampled value.
+     * @param timestampMillis Time of the measurement, in milliseconds since the Unix epoch.
+     */
+    public void add(int oid, int iid, int rid, long value, long timestampMillis) {
+        this.send.addLong(oid, iid, rid, timestampMillis, value);
+    }
+
+    /**
+     * Adds a floating-point sample to the current batch.
+     *
+     * @param oid Object ID.
+     * @param iid Object Instance ID.
+     * @param rid Resource ID.
+     * @param value Sampled value.
+     * @param timestampMillis Time of the measurement, in milliseconds since the Unix epoch.
+     */
+    public void add(int oid, int iid, int rid, double value, long timestampMillis) {
+        this.send.addDouble(oid, iid, rid, timestampMillis, value);
+    }
+
+    /**
+     * Adds a boolean sample to the current batch.
+     *
+     * @param oid Object ID.
+     * @param iid Object Instance ID.
+     * @param rid Resource ID.
+     * @param value Sampled value.
+     * @param timestampMillis Time of the measurement, in milliseconds since the Unix epoch.
+     */
+    public void add(int oid, int iid, int rid, boolean value, long timestampMillis) {
+        this.send.addBoolean(oid, iid, rid, timestampMillis, value);
+    }
+
+    /** Same as {@link #add(int, int, int, long, long)}, timestamped with the current time. */
+    public void add(int oid, int iid, int rid, long value) {
+        add(oid, iid, rid, value, System.currentTimeMillis());
+    }
+
+    /** Same as {@link #add(int, int, int, double, long)}, timestamped with the current time. */
+    public void add(int oid, int iid, int rid, double value) {
+        add(oid, iid, rid, value, System.currentTimeMillis());
+    }
+
+    /** Same as {@link #add(int, int, int, boolean, long)}, timestamped with the current time. */
+    public void add(int oid, int iid, int rid, boolean value) {
+        add(oid, iid, rid, value, System.currentTimeMillis());
+    }
+
+    /**
+     * Returns the number of samples in the current, not yet sent batch.
+     *
+     * @return Number of pending samples.
+     */
+    public int getPendingSamples() {
+        return this.send.getPendingSamples();
+    }
+
+    /** Sends the current batch immediately. Does nothing if it is empty. */
+    public void flush() {
+        this.send.flush();
+    }
+
+    /**
+     * Sends the pending samples and releases native resources. Batches already sent are still
+     * delivered, and their results reported.
+     */
+    @Override
+    public void close() {
+        this.send.close();
+    }
+}
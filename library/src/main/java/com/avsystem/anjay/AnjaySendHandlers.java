@@ -0,0 +1,31 @@
+/*
+ * Copyright 2020-2024 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package com.avsystem.anjay;
+
+import com.avsystem.anjay.AnjaySend.Result;
+
+/** Interface specifying handlers to be called when batches sent by {@link AnjaySend} finish. */
+public interface AnjaySendHandlers {
+    /**
+     * Called after a batch is delivered or its delivery fails.
+     *
+     * @param sampleCount Number of samples in the batch.
+     * @param result Result of the Send request.
+     * @param details CoAP response code if result is {@link Result#REJECTED REJECTED}, Anjay error
+     *     code if result is {@link Result#FAILED FAILED}, 0 otherwise.
+     */
+    void onSendFinished(int sampleCount, Result result, int details);
+}
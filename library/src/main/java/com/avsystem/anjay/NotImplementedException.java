@@ -0,0 +1,31 @@
+/*
+ * Copyright 2020-2024 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package com.avsystem.anjay;
+
+/**
+ * Thrown by default implementations of handlers that an object does not support. These are hit
+ * routinely, e.g. by servers discovering what an object can do, so no stack trace is captured.
+ */
+final class NotImplementedException extends UnsupportedOperationException {
+    NotImplementedException(String message) {
+        super(message);
+    }
+
+    @Override
+    public synchronized Throwable fillInStackTrace() {
+        return this;
+    }
+}
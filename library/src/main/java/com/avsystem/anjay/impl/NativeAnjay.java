@@ -17,13 +17,18 @@
 package com.avsystem.anjay.impl;
 
 import com.avsystem.anjay.Anjay.Configuration;
+import com.avsystem.anjay.Anjay.ObservationListener;
+import com.avsystem.anjay.Anjay.ObservationStatus;
 import com.avsystem.anjay.Anjay.SocketEntry;
+import com.avsystem.anjay.Anjay.SocketStats;
 import com.avsystem.anjay.Anjay.Transport;
+import com.avsystem.anjay.AnjayAttributes;
 import com.avsystem.anjay.AnjayException;
 import com.avsystem.anjay.AnjayObject;
 import java.nio.channels.SelectableChannel;
 import java.time.Duration;
 import java.util.ArrayList;
+import java.util.Arrays;
 import java.util.HashMap;
 import java.util.List;
 import java.util.Map;
@@ -39,6 +44,10 @@ public final class NativeAnjay implements AutoCloseable {
 
     private native void anjayServe(long socketPtr);
 
+    private native int anjayFlushSocket(long socketPtr);
+
+    private native SocketStats anjayGetSocketStats(long socketPtr);
+
     private native void anjaySchedRun();
 
     private native Duration anjaySchedTimeToNext();
@@ -63,6 +72,32 @@ public final class NativeAnjay implements AutoCloseable {
 
     private native int anjayNotifyInstancesChanged(int oid);
 
+    private native boolean anjayPostNotifyChanged(int oid, int iid, int rid);
+
+    private native boolean anjayPostNotifyInstancesChanged(int oid);
+
+    private native boolean anjayPostRegistrationUpdate(int ssid);
+
+    private native boolean anjayPostTransportEnterOffline(NativeTransportSet transportSet);
+
+    private native boolean anjayPostTransportExitOffline(NativeTransportSet transportSet);
+
+    private native boolean anjayIngestSample(
+            int oid, int iid, int rid, double value, long timestampNanos);
+
+    private native void anjaySetSampleAttrs(
+            int ssid, int oid, int iid, int rid, AnjayAttributes.ResourceAttrs attrs);
+
+    private native ObservationStatus anjayGetObservationStatus(int oid, int iid, int rid);
+
+    private native ObservationStatus[] anjayGetObservedResources();
+
+    private native void anjayWatchObservation(int oid, int iid, int rid);
+
+    private native void anjayUnwatchObservation(int oid, int iid, int rid);
+
+    private native void anjaySetObservationListener(ObservationListener listener);
+
     private native int anjayRegisterObject(NativeAnjayObject object);
 
     private native boolean anjayHasSecurityConfigForUri(String uri);
@@ -71,6 +106,10 @@ public final class NativeAnjay implements AutoCloseable {
 
     private native void cleanup();
 
+    public static native void setReconnectRateLimit(double requestsPerSecond);
+
+    public static native void setHostResolver(Anjay.HostResolver resolver, long cacheTtlMs);
+
     public static native String getVersion();
 
     public static native int getSsidAny();
@@ -149,6 +188,30 @@ public final class NativeAnjay implements AutoCloseable {
         throw new IllegalArgumentException("Passed channel does not belong to any known channels");
     }
 
+    public void flush(SelectableChannel channel) throws Exception {
+        ensureValidState();
+        for (SocketEntry entry : this.sockets) {
+            if (entry.channel == channel) {
+                int result = this.anjayFlushSocket(this.nativeSockets.get(entry).getSocketPtr());
+                if (result < 0) {
+                    throw new Exception("could not flush pending output");
+                }
+                return;
+            }
+        }
+        throw new IllegalArgumentException("Passed channel does not belong to any known channels");
+    }
+
+    public SocketStats getSocketStats(SelectableChannel channel) {
+        ensureValidState();
+        for (SocketEntry entry : this.sockets) {
+            if (entry.channel == channel) {
+                return this.anjayGetSocketStats(this.nativeSockets.get(entry).getSocketPtr());
+            }
+        }
+        throw new IllegalArgumentException("Passed channel does not belong to any known channels");
+    }
+
     public Optional<Duration> timeToNext() {
         ensureValidState();
         return Optional.ofNullable(this.anjaySchedTimeToNext());
@@ -191,6 +254,67 @@ public final class NativeAnjay implements AutoCloseable {
         }
     }
 
+    public boolean postNotifyChanged(int oid, int iid, int rid) {
+        ensureValidState();
+        return this.anjayPostNotifyChanged(oid, iid, rid);
+    }
+
+    public boolean postNotifyInstancesChanged(int oid) {
+        ensureValidState();
+        return this.anjayPostNotifyInstancesChanged(oid);
+    }
+
+    public boolean postRegistrationUpdate(int ssid) {
+        ensureValidState();
+        return this.anjayPostRegistrationUpdate(ssid);
+    }
+
+    public boolean postEnterOffline(Set<Transport> transportSet) {
+        ensureValidState();
+        return this.anjayPostTransportEnterOffline(NativeTransportSet.fromSet(transportSet));
+    }
+
+    public boolean postExitOffline(Set<Transport> transportSet) {
+        ensureValidState();
+        return this.anjayPostTransportExitOffline(NativeTransportSet.fromSet(transportSet));
+    }
+
+    public boolean ingestSample(int oid, int iid, int rid, double value, long timestampNanos) {
+        ensureValidState();
+        return this.anjayIngestSample(oid, iid, rid, value, timestampNanos);
+    }
+
+    public void setSampleAttributes(
+            int ssid, int oid, int iid, int rid, AnjayAttributes.ResourceAttrs attrs) {
+        ensureValidState();
+        this.anjaySetSampleAttrs(ssid, oid, iid, rid, attrs);
+    }
+
+    public ObservationStatus getObservationStatus(int oid, int iid, int rid) {
+        ensureValidState();
+        return this.anjayGetObservationStatus(oid, iid, rid);
+    }
+
+    public List<ObservationStatus> getObservedResources() {
+        ensureValidState();
+        return Arrays.asList(this.anjayGetObservedResources());
+    }
+
+    public void watchObservation(int oid, int iid, int rid) {
+        ensureValidState();
+        this.anjayWatchObservation(oid, iid, rid);
+    }
+
+    public void unwatchObservation(int oid, int iid, int rid) {
+        ensureValidState();
+        this.anjayUnwatchObservation(oid, iid, rid);
+    }
+
+    public void setObservationListener(ObservationListener listener) {
+        ensureValidState();
+        this.anjaySetObservationListener(listener);
+    }
+
     public void disableServer(int ssid) {
         ensureValidState();
         int result = this.anjayDisableServer(ssid);
@@ -21,6 +21,7 @@ import com.avsystem.anjay.AnjayDownload.Configuration;
 import com.avsystem.anjay.AnjayDownload.Result;
 import com.avsystem.anjay.AnjayDownload.ResultDetails;
 import com.avsystem.anjay.AnjayDownloadHandlers;
+import java.nio.ByteBuffer;
 import java.util.Optional;
 
 public final class NativeAnjayDownload {
@@ -36,18 +37,29 @@ public final class NativeAnjayDownload {
 
     public NativeAnjayDownload(Anjay anjay, Configuration config, AnjayDownloadHandlers handlers)
             throws Exception {
+        if (!overridesOnNextBlock(handlers, ByteBuffer.class)
+                && !overridesOnNextBlock(handlers, byte[].class)) {
+            throw new IllegalArgumentException(
+                    "handlers MUST implement one of the onNextBlock() overloads");
+        }
         this.handlers = handlers;
         this.init(NativeUtils.getNativeAnjay(anjay), config, handlers);
     }
 
-    private void onNextBlock(byte[] data, Optional<byte[]> etag) throws Exception {
-        handlers.onNextBlock(data, etag);
-    }
-
     private void onDownloadFinished(Result result, Optional<ResultDetails> details) {
         handlers.onDownloadFinished(result, details);
     }
 
+    private static boolean overridesOnNextBlock(AnjayDownloadHandlers handlers, Class<?> dataType) {
+        try {
+            return !handlers.getClass()
+                    .getMethod("onNextBlock", dataType, Optional.class)
+                    .isDefault();
+        } catch (NoSuchMethodException e) {
+            return false;
+        }
+    }
+
     public void abort() {
         downloadAbort();
     };
@@ -0,0 +1,74 @@
+/*
+ * Copyright 2020-2024 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package com.avsystem.anjay.impl;
+
+import com.avsystem.anjay.Anjay;
+import com.avsystem.anjay.AnjaySend.Configuration;
+import com.avsystem.anjay.AnjaySendHandlers;
+
+public final class NativeAnjaySend implements AutoCloseable {
+    private long self;
+
+    private native void init(NativeAnjay anjay, Configuration config, AnjaySendHandlers handlers);
+
+    private native void cleanup();
+
+    private native void sendAddLong(int oid, int iid, int rid, long timestamp, long value);
+
+    private native void sendAddDouble(int oid, int iid, int rid, long timestamp, double value);
+
+    private native void sendAddBoolean(int oid, int iid, int rid, long timestamp, boolean value);
+
+    private native int sendGetPendingSamples();
+
+    private native void sendFlush();
+
+    public NativeAnjaySend(Anjay anjay, Configuration config, AnjaySendHandlers handlers)
+            throws Exception {
+        this.init(NativeUtils.getNativeAnjay(anjay), config, handlers);
+    }
+
+    public void addLong(int oid, int iid, int rid, long timestamp, long value) {
+        sendAddLong(oid, iid, rid, timestamp, value);
+    }
+
+    public void addDouble(int oid, int iid, int rid, long timestamp, double value) {
+        sendAddDouble(oid, iid, rid, timestamp, value);
+    }
+
+    public void addBoolean(int oid, int iid, int rid, long timestamp, boolean value) {
+        sendAddBoolean(oid, iid, rid, timestamp, value);
+    }
+
+    public int getPendingSamples() {
+        return sendGetPendingSamples();
+    }
+
+    public void flush() {
+        sendFlush();
+    }
+
+    @Override
+    public void close() {
+        try {
+            if (sendGetPendingSamples() > 0) {
+                sendFlush();
+            }
+        } finally {
+            this.cleanup();
+        }
+    }
+}
@@ -13,13 +13,125 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
-
 package com.avsystem.anjay.impl;
 
+import java.util.Enumeration;
+import java.util.Set;
+import java.util.concurrent.ConcurrentHashMap;
+import java.util.logging.Level;
+import java.util.logging.LogManager;
+import java.util.logging.Logger;
+
 public final class NativeLog {
     static {
         System.loadLibrary("anjay-jni");
     }
 
+    private static final String ROOT_LOGGER = "Anjay";
+    private static final String MODULE_PREFIX = ROOT_LOGGER + ".";
+
+    // Native modules that have logged anything so far.
+    private static final Set<String> MODULES = ConcurrentHashMap.newKeySet();
+
+    // Level applied to all native modules while the ring is enabled, regardless of the loggers.
+    private static Level ringLevel;
+
     public static native void initialize();
+
+    private static native void setDefaultLevel(int level);
+
+    private static native void setModuleLevel(String module, int level);
+
+    public static native void enableAsync(int capacity);
+
+    public static native void disableAsync();
+
+    public static native long getDroppedMessages();
+
+    private static native void openRing(String path, long size);
+
+    private static native void closeRing();
+
+    public static native byte[] snapshotRing();
+
+    private static native String[] takeNewModules();
+
+    public static native void setMaxStackFrames(int frames);
+
+    /**
+     * Makes native code drop messages that would be discarded by the corresponding loggers anyway,
+     * so that they are never formatted nor passed to Java.
+     */
+    public static synchronized void syncLevels() {
+        setDefaultLevel(levelFor(Logger.getLogger(ROOT_LOGGER)));
+        LogManager manager = LogManager.getLogManager();
+        for (Enumeration<String> names = manager.getLoggerNames(); names.hasMoreElements(); ) {
+            String name = names.nextElement();
+            if (!name.startsWith(MODULE_PREFIX)) {
+                continue;
+            }
+            Logger logger = manager.getLogger(name);
+            if (logger != null) {
+                setModuleLevel(name.substring(MODULE_PREFIX.length()), levelFor(logger));
+            }
+        }
+        for (String module : MODULES) {
+            syncModule(module);
+        }
+    }
+
+    /**
+     * Synchronizes levels of native modules that have logged their first message since the last
+     * call, so that e.g. an <code>Anjay.foo.level</code> logging property takes effect even if the
+     * <code>Anjay.foo</code> logger did not exist when {@link #syncLevels()} was called.
+     */
+    public static void syncNewModules() {
+        String[] modules = takeNewModules();
+        if (modules == null) {
+            return;
+        }
+        synchronized (NativeLog.class) {
+            for (String module : modules) {
+                MODULES.add(module);
+                syncModule(module);
+            }
+        }
+    }
+
+    /**
+     * Makes native messages be written to a ring file instead of being passed to Java, with the
+     * given level applied to all modules until {@link #disableRing()} is called.
+     */
+    public static synchronized void enableRing(String path, long size, Level level) {
+        // Throws if the ring cannot be created, leaving the current mode and levels unchanged.
+        openRing(path, size);
+        ringLevel = level;
+        syncLevels();
+    }
+
+    /** Stops writing to the ring file and goes back to levels of the loggers. */
+    public static synchronized void disableRing() {
+        closeRing();
+        ringLevel = null;
+        syncLevels();
+    }
+
+    private static void syncModule(String module) {
+        // Creating the logger makes LogManager apply its configured level, if any.
+        setModuleLevel(module, levelFor(Logger.getLogger(MODULE_PREFIX + module)));
+    }
+
+    private static int levelFor(Logger logger) {
+        return ringLevel != null ? ringLevel.intValue() : effectiveLevel(logger);
+    }
+
+    private static int effectiveLevel(Logger logger) {
+        for (; logger != null; logger = logger.getParent()) {
+            Level level = logger.getLevel();
+            if (level != null) {
+                return level.intValue();
+            }
+        }
+        return Level.INFO.intValue();
+    }
 }
@@ -27,13 +27,15 @@ public final class NativeSocketEntry {
     private final int ssid;
     private final boolean queueMode;
     private final int port;
+    private final boolean pendingOutput;
 
     public long getSocketPtr() {
         return this.socketPtr;
     }
 
     public SocketEntry intoSocketEntry() {
-        return new SocketEntry(this.channel, this.transport, this.ssid, this.queueMode, this.port);
+        return new SocketEntry(this.channel, this.transport, this.ssid, this.queueMode, this.port,
+                this.pendingOutput);
     }
 
     private NativeSocketEntry(
@@ -42,12 +44,14 @@ public final class NativeSocketEntry {
             long socketPtr,
             int ssid,
             boolean queueMode,
-            int port) {
+            int port,
+            boolean pendingOutput) {
         this.transport = transport;
         this.channel = channel;
         this.socketPtr = socketPtr;
         this.ssid = ssid;
         this.queueMode = queueMode;
         this.port = port;
+        this.pendingOutput = pendingOutput;
     }
 }
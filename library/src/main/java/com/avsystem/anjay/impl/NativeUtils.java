@@ -51,43 +51,50 @@ public final class NativeUtils {
         }
     }
 
-    public static ReadyState waitUntilReady(
-            SelectableChannel channel, Duration timeout, ReadyState waitStates) throws IOException {
-        try (Selector selector = Selector.open()) {
-            int waitMask = 0;
-            if (waitStates.read) {
-                waitMask |= SelectionKey.OP_READ;
-            }
-            if (waitStates.write) {
-                waitMask |= SelectionKey.OP_WRITE;
-            }
-            if (waitStates.connect) {
-                waitMask |= SelectionKey.OP_CONNECT;
+    private static int interestOps(ReadyState waitStates) {
+        int waitMask = 0;
+        if (waitStates.read) {
+            waitMask |= SelectionKey.OP_READ;
+        }
+        if (waitStates.write) {
+            waitMask |= SelectionKey.OP_WRITE;
+        }
+        if (waitStates.connect) {
+            waitMask |= SelectionKey.OP_CONNECT;
+        }
+        if (waitStates.accept) {
+            waitMask |= SelectionKey.OP_ACCEPT;
+        }
+        return waitMask;
+    }
+
+    private static void selectUntilReady(Selector selector, Duration timeout) throws IOException {
+        // NOTE: Java doesn't seem to have any higher level APIs around monotonic
+        // clock... The standard available monotonic time source is System.nanoTime().
+        final long deadlineNs = System.nanoTime() + timeout.toNanos();
+        long remainingMs;
+        int readySockets;
+        do {
+            if (Thread.currentThread().isInterrupted()) {
+                remainingMs = 0;
+            } else {
+                remainingMs = (deadlineNs - System.nanoTime()) / 1_000_000;
             }
-            if (waitStates.accept) {
-                waitMask |= SelectionKey.OP_ACCEPT;
+            if (remainingMs <= 0) {
+                readySockets = selector.selectNow();
+            } else {
+                // Interrupting a thread does not sometimes break out of Selector.select()
+                // (e.g. on Android), so let's limit the wait time to 1 second.
+                readySockets = selector.select(Math.min(remainingMs, 1000));
             }
+        } while (readySockets == 0 && remainingMs > 0);
+    }
 
-            SelectionKey key = channel.register(selector, waitMask);
-            // NOTE: Java doesn't seem to have any higher level APIs around monotonic
-            // clock... The standard available monotonic time source is System.nanoTime().
-            final long deadlineNs = System.nanoTime() + timeout.toNanos();
-            long remainingMs;
-            int readySockets;
-            do {
-                if (Thread.currentThread().isInterrupted()) {
-                    remainingMs = 0;
-                } else {
-                    remainingMs = (deadlineNs - System.nanoTime()) / 1_000_000;
-                }
-                if (remainingMs <= 0) {
-                    readySockets = selector.selectNow();
-                } else {
-                    // Interrupting a thread does not sometimes break out of Selector.select()
-                    // (e.g. on Android), so let's limit the wait time to 1 second.
-                    readySockets = selector.select(Math.min(remainingMs, 1000));
-                }
-            } while (readySockets == 0 && remainingMs > 0);
+    public static ReadyState waitUntilReady(
+            SelectableChannel channel, Duration timeout, ReadyState waitStates) throws IOException {
+        try (Selector selector = Selector.open()) {
+            SelectionKey key = channel.register(selector, interestOps(waitStates));
+            selectUntilReady(selector, timeout);
 
             ReadyState result = new ReadyState();
             if (selector.selectedKeys().contains(key)) {
@@ -99,4 +106,30 @@ public final class NativeUtils {
             return result;
         }
     }
+
+    /**
+     * Waits until any of the <code>channels</code> becomes ready for any of the operations
+     * specified in <code>waitStates</code>.
+     *
+     * @return Index of the first ready channel, or -1 if none became ready before the timeout.
+     */
+    public static int waitUntilAnyReady(
+            SelectableChannel[] channels, Duration timeout, ReadyState waitStates)
+            throws IOException {
+        try (Selector selector = Selector.open()) {
+            final int waitMask = interestOps(waitStates);
+            SelectionKey[] keys = new SelectionKey[channels.length];
+            for (int i = 0; i < channels.length; ++i) {
+                keys[i] = channels[i].register(selector, waitMask);
+            }
+            selectUntilReady(selector, timeout);
+
+            for (int i = 0; i < keys.length; ++i) {
+                if (selector.selectedKeys().contains(keys[i])) {
+                    return i;
+                }
+            }
+            return -1;
+        }
+    }
 }
@@ -0,0 +1,74 @@
+/*
+ * Copyright 2020-2024 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package com.avsystem.anjay.benchmark;
+
+import com.avsystem.anjay.AnjayObject;
+import com.avsystem.anjay.AnjayOutputContext;
+import java.util.SortedSet;
+import java.util.TreeSet;
+
+/** Minimal object with one Resource per value kind exercised by the benchmark. */
+public final class BenchmarkObject implements AnjayObject {
+    public static final int OID = 33000;
+    public static final int RID_INT = 0;
+    public static final int RID_STRING = 1;
+    public static final int RID_BYTES = 2;
+
+    private final byte[] payload;
+
+    public BenchmarkObject(int payloadSize) {
+        this.payload = new byte[payloadSize];
+    }
+
+    @Override
+    public int oid() {
+        return OID;
+    }
+
+    @Override
+    public SortedSet<Integer> instances() {
+        TreeSet<Integer> instances = new TreeSet<>();
+        instances.add(0);
+        return instances;
+    }
+
+    @Override
+    public SortedSet<ResourceDef> resources(int iid) {
+        TreeSet<ResourceDef> resourceDefs = new TreeSet<>();
+        resourceDefs.add(new ResourceDef(RID_INT, ResourceKind.R, true));
+        resourceDefs.add(new ResourceDef(RID_STRING, ResourceKind.R, true));
+        resourceDefs.add(new ResourceDef(RID_BYTES, ResourceKind.R, true));
+        return resourceDefs;
+    }
+
+    @Override
+    public void resourceRead(int iid, int rid, AnjayOutputContext context) throws Exception {
+        switch (rid) {
+            case RID_INT:
+                context.retInt(42);
+                break;
+            case RID_STRING:
+                context.retString("benchmark");
+                break;
+            case RID_BYTES:
+                context.retBytes(payload);
+                break;
+            default:
+                throw new IllegalArgumentException("Unsupported resource " + rid);
+        }
+    }
+}
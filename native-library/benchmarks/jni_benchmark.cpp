@@ -0,0 +1,410 @@
+/*
+ * Copyright 2020-2024 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "../src/jni_wrapper.hpp"
+
+#include <anjay/anjay.h>
+#include <anjay/lwm2m_send.h>
+
+#include <avsystem/commons/avs_log.h>
+#include <avsystem/commons/avs_socket.h>
+
+#include "../src/global_context.hpp"
+#include "../src/native_anjay.hpp"
+#include "../src/util_classes/exception.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+// Every operator new in the process, including the ones in anjay-jni, ends
+// up here, which makes native allocations per operation easy to count.
+// Allocations done by Anjay and avs_commons through avs_malloc() are not
+// included.
+namespace {
+std::atomic<size_t> NATIVE_ALLOCATIONS;
+} // namespace
+
+void *operator new(size_t size) {
+    NATIVE_ALLOCATIONS.fetch_add(1, std::memory_order_relaxed);
+    if (void *ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+namespace {
+
+struct MathTag {
+    static constexpr auto Name() {
+        return "java/lang/Math";
+    }
+};
+
+struct ThreadTag {
+    static constexpr auto Name() {
+        return "java/lang/Thread";
+    }
+};
+
+struct ManagementFactoryTag {
+    static constexpr auto Name() {
+        return "java/lang/management/ManagementFactory";
+    }
+};
+
+struct PlatformThreadMXBeanTag {
+    static constexpr auto Name() {
+        return "java/lang/management/ThreadMXBean";
+    }
+};
+
+struct ThreadMXBeanTag {
+    static constexpr auto Name() {
+        return "com/sun/management/ThreadMXBean";
+    }
+};
+
+struct LoggerTag {
+    static constexpr auto Name() {
+        return "java/util/logging/Logger";
+    }
+};
+
+struct LevelTag {
+    static constexpr auto Name() {
+        return "java/util/logging/Level";
+    }
+};
+
+struct NativeLogTag {
+    static constexpr auto Name() {
+        return "com/avsystem/anjay/impl/NativeLog";
+    }
+};
+
+struct AnjayTag {
+    static constexpr auto Name() {
+        return "com/avsystem/anjay/Anjay";
+    }
+};
+
+struct ConfigurationTag {
+    static constexpr auto Name() {
+        return "com/avsystem/anjay/Anjay$Configuration";
+    }
+};
+
+struct AnjayObjectTag {
+    static constexpr auto Name() {
+        return "com/avsystem/anjay/AnjayObject";
+    }
+};
+
+struct BenchmarkObjectTag {
+    static constexpr auto Name() {
+        return "com/avsystem/anjay/benchmark/BenchmarkObject";
+    }
+};
+
+constexpr anjay_oid_t BENCHMARK_OID = 33000;
+constexpr anjay_rid_t BENCHMARK_RID_INT = 0;
+constexpr anjay_rid_t BENCHMARK_RID_STRING = 1;
+constexpr anjay_rid_t BENCHMARK_RID_BYTES = 2;
+constexpr jni::jint BENCHMARK_PAYLOAD_SIZE = 1024;
+
+// Reads the number of bytes allocated on the Java heap by the calling thread.
+class JavaAllocationCounter {
+    jni::Global<jni::Object<ThreadMXBeanTag>> bean_;
+    jni::Global<jni::Class<ThreadMXBeanTag>> class_;
+    jni::jlong thread_id_;
+
+public:
+    explicit JavaAllocationCounter(jni::JNIEnv &env) : thread_id_() {
+        auto &factory = jni::Class<ManagementFactoryTag>::Singleton(env);
+        auto get_bean = factory.GetStaticMethod<
+                jni::Object<PlatformThreadMXBeanTag>()>(env,
+                                                        "getThreadMXBean");
+        class_ = jni::NewGlobal(env, jni::Class<ThreadMXBeanTag>::Find(env));
+        bean_ = jni::NewGlobal(env,
+                               jni::Cast(env, class_,
+                                         factory.Call(env, get_bean)));
+
+        auto &thread = jni::Class<ThreadTag>::Singleton(env);
+        auto current = thread.Call(
+                env,
+                thread.GetStaticMethod<jni::Object<ThreadTag>()>(
+                        env, "currentThread"));
+        thread_id_ = current.Call(
+                env, thread.GetMethod<jni::jlong()>(env, "getId"));
+    }
+
+    jni::jlong allocated_bytes(jni::JNIEnv &env) {
+        static const auto method =
+                class_.GetMethod<jni::jlong(jni::jlong)>(
+                        env, "getThreadAllocatedBytes");
+        return bean_.Call(env, method, thread_id_);
+    }
+};
+
+class Runner {
+    jni::JNIEnv &env_;
+    JavaAllocationCounter java_allocations_;
+    size_t iterations_;
+
+public:
+    Runner(jni::JNIEnv &env, size_t iterations)
+            : env_(env), java_allocations_(env), iterations_(iterations) {
+        std::printf("%-32s %12s %16s %16s\n", "benchmark", "ns/op",
+                    "native allocs/op", "java bytes/op");
+    }
+
+    void run(const char *name, const std::function<void()> &op) {
+        for (size_t i = 0; i < iterations_ / 10; ++i) {
+            op();
+        }
+
+        const size_t allocations_before = NATIVE_ALLOCATIONS.load();
+        const jni::jlong java_before = java_allocations_.allocated_bytes(env_);
+        const auto time_before = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations_; ++i) {
+            op();
+        }
+        const auto time_after = std::chrono::steady_clock::now();
+        const jni::jlong java_after = java_allocations_.allocated_bytes(env_);
+        const size_t allocations_after = NATIVE_ALLOCATIONS.load();
+
+        const double ns =
+                std::chrono::duration<double, std::nano>(time_after
+                                                         - time_before)
+                        .count();
+        const double n = static_cast<double>(iterations_);
+        std::printf("%-32s %12.1f %16.2f %16.1f\n", name, ns / n,
+                    static_cast<double>(allocations_after - allocations_before)
+                            / n,
+                    static_cast<double>(java_after - java_before) / n);
+    }
+};
+
+// Keeps messages reaching java.util.logging, but prevents them from being
+// printed, so that only the cost of the bridge is measured.
+void silence_java_logging(jni::JNIEnv &env) {
+    auto &logger_class = jni::Class<LoggerTag>::Singleton(env);
+    auto logger = logger_class.Call(
+            env,
+            logger_class.GetStaticMethod<jni::Object<LoggerTag>(jni::String)>(
+                    env, "getLogger"),
+            jni::Make<jni::String>(env, "Anjay"));
+    logger.Call(env,
+                logger_class.GetMethod<void(jni::jboolean)>(
+                        env, "setUseParentHandlers"),
+                jni::jni_false);
+
+    auto &level_class = jni::Class<LevelTag>::Singleton(env);
+    logger.Call(env,
+                logger_class.GetMethod<void(jni::Object<LevelTag>)>(
+                        env, "setLevel"),
+                level_class.Get(env,
+                                level_class.GetStaticField<
+                                        jni::Object<LevelTag>>(env, "INFO")));
+
+    // The first call into NativeLog loads the library, which runs
+    // JNI_OnLoad() and thus sets up GlobalContext for the rest of the run.
+    auto &native_log = jni::Class<NativeLogTag>::Singleton(env);
+    native_log.Call(env,
+                    native_log.GetStaticMethod<void()>(env, "initialize"));
+    native_log.Call(env,
+                    native_log.GetStaticMethod<void()>(env, "syncLevels"));
+}
+
+jni::Local<jni::Object<AnjayTag>> create_anjay(jni::JNIEnv &env) {
+    auto &config_class = jni::Class<ConfigurationTag>::Singleton(env);
+    auto config =
+            config_class.New(env, config_class.GetConstructor<>(env));
+    config.Set(env,
+               config_class.GetField<jni::String>(env, "endpointName"),
+               jni::Make<jni::String>(env, "anjay-jni-benchmark"));
+
+    auto &anjay_class = jni::Class<AnjayTag>::Singleton(env);
+    auto anjay = anjay_class.New(
+            env,
+            anjay_class.GetConstructor<jni::Object<ConfigurationTag>>(env),
+            config);
+
+    auto &object_class = jni::Class<BenchmarkObjectTag>::Singleton(env);
+    auto object =
+            object_class.New(env,
+                             object_class.GetConstructor<jni::jint>(env),
+                             BENCHMARK_PAYLOAD_SIZE);
+    anjay.Call(env,
+               anjay_class.GetMethod<void(jni::Object<AnjayObjectTag>)>(
+                       env, "registerObject"),
+               jni::Cast(env, jni::Class<AnjayObjectTag>::Find(env), object));
+    return anjay;
+}
+
+std::shared_ptr<anjay_t> get_native_anjay(jni::JNIEnv &env,
+                                          jni::Object<AnjayTag> &anjay) {
+    auto &anjay_class = jni::Class<AnjayTag>::Singleton(env);
+    auto native_anjay = anjay.Get(
+            env, anjay_class.GetField<jni::Object<NativeAnjay>>(env, "anjay"));
+    return NativeAnjay::into_native(native_anjay)->get_anjay();
+}
+
+// Reads a single Resource through the whole data model path: instance and
+// resource listing, the read handler and the output context natives.
+void read_resource(anjay_t *anjay, anjay_rid_t rid) {
+    anjay_send_batch_builder_t *builder = anjay_send_batch_builder_new();
+    if (!builder
+            || anjay_send_batch_data_add_current(builder, anjay, BENCHMARK_OID,
+                                                 0, rid)) {
+        std::cerr << "Could not read /" << BENCHMARK_OID << "/0/" << rid
+                  << std::endl;
+        std::exit(EXIT_FAILURE);
+    }
+    anjay_send_batch_builder_cleanup(&builder);
+}
+
+avs_net_socket_t *create_loopback_socket() {
+    avs_net_socket_t *socket = nullptr;
+    char port[16];
+    if (avs_is_err(avs_net_udp_socket_create(&socket, nullptr))
+            || avs_is_err(avs_net_socket_bind(socket, "127.0.0.1", "0"))
+            || avs_is_err(avs_net_socket_get_local_port(socket, port,
+                                                        sizeof(port)))
+            || avs_is_err(avs_net_socket_connect(socket, "127.0.0.1", port))) {
+        std::cerr << "Could not set up the loopback socket" << std::endl;
+        std::exit(EXIT_FAILURE);
+    }
+    return socket;
+}
+
+void run_benchmarks(jni::JNIEnv &env, size_t iterations) {
+    silence_java_logging(env);
+
+    auto anjay_object = create_anjay(env);
+    std::shared_ptr<anjay_t> anjay = get_native_anjay(env, anjay_object);
+
+    Runner runner{ env, iterations };
+
+    auto &math = jni::Class<MathTag>::Singleton(env);
+    auto abs = math.GetStaticMethod<jni::jint(jni::jint)>(env, "abs");
+    runner.run("upcall/static", [&]() { math.Call(env, abs, -1); });
+
+    runner.run("exception/translate", [&]() {
+        try {
+            avs_throw(IllegalArgumentException(env, "benchmark"));
+        } catch (jni::PendingJavaException &) {
+            jni::ExceptionClear(env);
+        }
+    });
+
+    runner.run("log/passed", [&]() {
+        avs_log(jni_benchmark, INFO, "benchmark message %d", 42);
+    });
+    runner.run("log/filtered", [&]() {
+        avs_log(jni_benchmark, DEBUG, "benchmark message %d", 42);
+    });
+
+    runner.run("object/read_int",
+               [&]() { read_resource(anjay.get(), BENCHMARK_RID_INT); });
+    runner.run("object/read_string",
+               [&]() { read_resource(anjay.get(), BENCHMARK_RID_STRING); });
+    runner.run("object/read_bytes",
+               [&]() { read_resource(anjay.get(), BENCHMARK_RID_BYTES); });
+
+    avs_net_socket_t *socket = create_loopback_socket();
+    std::vector<char> datagram(256);
+    runner.run("socket/udp_roundtrip", [&]() {
+        size_t received = 0;
+        if (avs_is_err(avs_net_socket_send(socket, datagram.data(),
+                                           datagram.size()))
+                || avs_is_err(avs_net_socket_receive(socket, &received,
+                                                     datagram.data(),
+                                                     datagram.size()))) {
+            std::cerr << "Loopback datagram lost" << std::endl;
+            std::exit(EXIT_FAILURE);
+        }
+    });
+    avs_net_socket_cleanup(&socket);
+
+    anjay.reset();
+    anjay_object.Call(env,
+                      jni::Class<AnjayTag>::Singleton(env).GetMethod<void()>(
+                              env, "close"));
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0]
+                  << " CLASSPATH LIBRARY_PATH [ITERATIONS]" << std::endl;
+        return EXIT_FAILURE;
+    }
+    const size_t iterations =
+            argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 100000;
+
+    std::string class_path = std::string{ "-Djava.class.path=" } + argv[1];
+    std::string library_path =
+            std::string{ "-Djava.library.path=" } + argv[2];
+    JavaVMOption options[] = { { &class_path[0], nullptr },
+                               { &library_path[0], nullptr } };
+
+    JavaVMInitArgs vm_args{};
+    vm_args.version = JNI_VERSION_1_6;
+    vm_args.nOptions = sizeof(options) / sizeof(*options);
+    vm_args.options = options;
+    vm_args.ignoreUnrecognized = JNI_FALSE;
+
+    JavaVM *vm = nullptr;
+    JNIEnv *raw_env = nullptr;
+    if (JNI_CreateJavaVM(&vm, reinterpret_cast<void **>(&raw_env), &vm_args)
+            != JNI_OK) {
+        std::cerr << "Could not start the JVM" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    int result = EXIT_SUCCESS;
+    try {
+        run_benchmarks(*raw_env, iterations);
+    } catch (jni::PendingJavaException &) {
+        raw_env->ExceptionDescribe();
+        result = EXIT_FAILURE;
+    } catch (std::exception &e) {
+        std::cerr << "Benchmark failed: " << e.what() << std::endl;
+        result = EXIT_FAILURE;
+    }
+    vm->DestroyJavaVM();
+    return result;
+}
@@ -0,0 +1,148 @@
+/*
+ * Copyright 2020-2024 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "./async_log_sink.hpp"
+
+#include "./global_context.hpp"
+
+#include "./util_classes/level.hpp"
+#include "./util_classes/logger.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <unordered_map>
+
+namespace {
+
+// Upper bound for the time a message may wait if a wakeup is missed.
+constexpr std::chrono::milliseconds MAX_DELIVERY_DELAY{ 100 };
+
+constexpr const char ROOT_LOGGER[] = "Anjay";
+
+} // namespace
+
+AsyncLogSink::AsyncLogSink(size_t capacity)
+        : capacity_(capacity),
+          queue_(),
+          dropped_(0),
+          mutex_(),
+          wakeup_(),
+          stopping_(false),
+          thread_([this] { run(); }) {}
+
+AsyncLogSink::~AsyncLogSink() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wakeup_.notify_one();
+    thread_.join();
+}
+
+void AsyncLogSink::post(avs_log_level_t level,
+                        const char *module,
+                        const char *message) try {
+    if (queue_.size() >= capacity_) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    if (queue_.push(Record{ level, module, message })) {
+        wakeup_.notify_one();
+    }
+} catch (...) {
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t AsyncLogSink::dropped() const {
+    return dropped_.load(std::memory_order_relaxed);
+}
+
+void AsyncLogSink::run() try {
+    jni::UniqueEnv attached = GlobalContext::attach_daemon_thread();
+    jni::JNIEnv &env = *attached;
+
+    auto logger_class = jni::Class<utils::Logger>::Find(env);
+    auto get_logger = logger_class.GetStaticMethod<jni::Object<utils::Logger>(
+            jni::String)>(env, "getLogger");
+    auto log = logger_class.GetMethod<void(jni::Object<utils::Level>,
+                                           jni::String)>(env, "log");
+
+    std::unordered_map<std::string, jni::Global<jni::Object<utils::Logger>>>
+            loggers;
+    std::unordered_map<avs_log_level_t, jni::Global<jni::Object<utils::Level>>>
+            levels;
+    auto logger_for = [&](const std::string &name) -> auto & {
+        auto it = loggers.find(name);
+        if (it == loggers.end()) {
+            it = loggers
+                         .emplace(name,
+                                  jni::NewGlobal(
+                                          env,
+                                          logger_class.Call(
+                                                  env, get_logger,
+                                                  jni::Make<jni::String>(
+                                                          env, name))))
+                         .first;
+        }
+        return it->second;
+    };
+    auto level_for = [&](avs_log_level_t level) -> auto & {
+        auto it = levels.find(level);
+        if (it == levels.end()) {
+            it = levels.emplace(level,
+                                jni::NewGlobal(env, utils::Level::from_native(
+                                                            level)))
+                         .first;
+        }
+        return it->second;
+    };
+    auto deliver = [&](avs_log_level_t level, const std::string &logger,
+                       const std::string &message) {
+        try {
+            logger_for(logger).Call(env, log, level_for(level),
+                                    jni::Make<jni::String>(env, message));
+        } catch (jni::PendingJavaException &) {
+            jni::ExceptionClear(env);
+            std::cerr << "Exception occurred while logging: " << message
+                      << std::endl;
+        }
+    };
+
+    uint64_t reported_dropped = 0;
+    bool stopping = false;
+    while (!stopping) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wakeup_.wait_for(lock, MAX_DELIVERY_DELAY,
+                             [&] { return stopping_ || !queue_.empty(); });
+            stopping = stopping_;
+        }
+        Record record;
+        while (queue_.pop(&record)) {
+            deliver(record.level, ROOT_LOGGER + ("." + record.module),
+                    record.message);
+        }
+        uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+        if (dropped != reported_dropped) {
+            deliver(AVS_LOG_WARNING, ROOT_LOGGER,
+                    std::to_string(dropped - reported_dropped)
+                            + " log messages dropped");
+            reported_dropped = dropped;
+        }
+    }
+} catch (...) {
+    std::cerr << "Asynchronous log delivery thread failed" << std::endl;
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright 2020-2024 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <avsystem/commons/avs_log.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "./mpsc_queue.hpp"
+
+/**
+ * avs_log backend that moves the cost of passing messages to
+ * java.util.logging off the threads that produce them.
+ *
+ * Messages are copied into a lock-free queue and delivered in batches by a
+ * background thread, which keeps the Logger object of every module it has
+ * seen. At most @p capacity messages are kept pending; any more are dropped
+ * and counted, and the loss is reported to Java once there is room again.
+ */
+class AsyncLogSink {
+    struct Record {
+        avs_log_level_t level;
+        std::string module;
+        std::string message;
+    };
+
+    const size_t capacity_;
+    MpscQueue<Record> queue_;
+    std::atomic<uint64_t> dropped_;
+
+    std::mutex mutex_;
+    std::condition_variable wakeup_;
+    bool stopping_;
+    std::thread thread_;
+
+    void run();
+
+    AsyncLogSink(const AsyncLogSink &) = delete;
+    AsyncLogSink &operator=(const AsyncLogSink &) = delete;
+
+public:
+    explicit AsyncLogSink(size_t capacity);
+
+    /**
+     * Delivers all messages that are still pending and stops the background
+     * thread.
+     */
+    ~AsyncLogSink();
+
+    /**
+     * May be called from any thread; never blocks on Java.
+     */
+    void post(avs_log_level_t level, const char *module, const char *message);
+
+    /**
+     * Returns the total number of messages dropped because the queue was full.
+     */
+    uint64_t dropped() const;
+};
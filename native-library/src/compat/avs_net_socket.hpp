@@ -22,11 +22,18 @@
 #include "../jni_wrapper.hpp"
 
 #include "../util_classes/selectable_channel.hpp"
+#include "./rtt_estimator.hpp"
 #include "./socket_channel.hpp"
-#include "./socket_error.hpp"
+#include "./socket_stats.hpp"
+#include "./traffic_capture.hpp"
 
 namespace compat {
 
+/**
+ * Interface of the compat socket layer. Routine failures (timeouts, refused
+ * connections, etc.) are reported through the returned avs_error_t; exceptions
+ * are reserved for conditions that indicate a bug or a JVM failure.
+ */
 class AvsSocketBase {
 public:
     virtual ~AvsSocketBase() {}
@@ -34,45 +41,139 @@ public:
     virtual jni::Local<jni::Object<utils::SelectableChannel>>
     selectable_channel() const = 0;
 
-    virtual void connect(const char *host, const char *port) = 0;
+    virtual avs_error_t connect(const char *host, const char *port) = 0;
 
-    virtual void send(const void *buffer, size_t buffer_length) = 0;
+    virtual avs_error_t send(const void *buffer, size_t buffer_length) = 0;
 
-    virtual void
+    virtual avs_error_t
     receive(size_t *out_size, void *buffer, size_t buffer_length) = 0;
 
-    virtual void bind(const char *localaddr, const char *port) = 0;
+    virtual avs_error_t bind(const char *localaddr, const char *port) = 0;
+
+    virtual avs_error_t close() = 0;
+
+    virtual avs_error_t shutdown() = 0;
+
+    virtual avs_error_t remote_host(char *out_buffer,
+                                    size_t out_buffer_size) = 0;
 
-    virtual void close() = 0;
+    virtual avs_error_t remote_hostname(char *out_buffer,
+                                        size_t out_buffer_size) = 0;
 
-    virtual void shutdown() = 0;
+    virtual avs_error_t remote_port(char *out_buffer,
+                                    size_t out_buffer_size) = 0;
 
-    virtual void remote_host(char *out_buffer, size_t out_buffer_size) = 0;
+    virtual avs_error_t local_host(char *out_buffer,
+                                   size_t out_buffer_size) = 0;
 
-    virtual void remote_hostname(char *out_buffer, size_t out_buffer_size) = 0;
+    virtual avs_error_t local_port(char *out_buffer,
+                                   size_t out_buffer_size) = 0;
 
-    virtual void remote_port(char *out_buffer, size_t out_buffer_size) = 0;
+    virtual avs_error_t
+    get_opt(avs_net_socket_opt_key_t option_key,
+            avs_net_socket_opt_value_t *out_option_value) = 0;
 
-    virtual void local_host(char *out_buffer, size_t out_buffer_size) = 0;
+    virtual avs_error_t set_opt(avs_net_socket_opt_key_t option_key,
+                                avs_net_socket_opt_value_t option_value) = 0;
 
-    virtual void local_port(char *out_buffer, size_t out_buffer_size) = 0;
+    virtual bool has_pending_output() const = 0;
 
-    virtual void get_opt(avs_net_socket_opt_key_t option_key,
-                         avs_net_socket_opt_value_t *out_option_value) = 0;
+    virtual avs_error_t flush() = 0;
 
-    virtual void set_opt(avs_net_socket_opt_key_t option_key,
-                         avs_net_socket_opt_value_t option_value) = 0;
+    virtual const SocketStats &stats() const = 0;
+
+    /**
+     * Starts estimating the round-trip time of CoAP exchanges on this socket,
+     * if it is capable of that. Called for sockets of clients with adaptive tx
+     * params enabled.
+     */
+    virtual void enable_rtt_estimation() {}
 };
 
+/**
+ * Writes out as much data queued on @p socket as possible without blocking.
+ * @p socket may be any socket created by Anjay, including (D)TLS ones - the
+ * operation is performed on the underlying system socket.
+ */
+avs_error_t flush_pending_output(avs_net_socket_t *socket);
+
+/**
+ * Enables RTT estimation on the system socket underlying @p socket (see
+ * AvsSocketBase::enable_rtt_estimation()).
+ */
+void enable_rtt_estimation(avs_net_socket_t *socket);
+
 template <typename ChannelType>
 class AvsSocket final : public AvsSocketBase {
+    SocketStats stats_;
     SocketChannel<ChannelType> channel_;
+    // Non-null if traffic recording is enabled; see traffic_capture.hpp.
+    std::shared_ptr<CaptureWriter> recorder_;
+    uint32_t capture_id_;
+    // Non-null if the owning client has adaptive tx params enabled and this is
+    // a UDP socket.
+    std::unique_ptr<RttEstimator> rtt_;
+    // Host name passed to connect(), under which the RTT estimate is published.
+    std::string rtt_host_;
+
+    void record(CaptureRecordType type,
+                avs_error_t err,
+                const void *data = nullptr,
+                size_t length = 0) {
+        if (recorder_) {
+            avs_errno_t status = static_cast<avs_errno_t>(0);
+            if (avs_is_err(err)) {
+                status = err.category == AVS_ERRNO_CATEGORY
+                                 ? static_cast<avs_errno_t>(err.code)
+                                 : AVS_EIO;
+            }
+            recorder_->write(type, capture_id_, status, data, length);
+        }
+    }
+
+    static avs_error_t print_string(char *out_buffer,
+                                    size_t out_buffer_size,
+                                    const std::string &value) {
+        if (value.empty()) {
+            return avs_errno(AVS_EBADF);
+        }
+        if (avs_simple_snprintf(out_buffer, out_buffer_size, "%s",
+                                value.c_str())
+                < 0) {
+            return avs_errno(AVS_ERANGE);
+        }
+        return AVS_OK;
+    }
+
+    static avs_error_t
+    print_port(char *out_buffer, size_t out_buffer_size, int port) {
+        if (port < 0) {
+            return avs_errno(AVS_EBADF);
+        }
+        if (avs_simple_snprintf(out_buffer, out_buffer_size, "%d", port) < 0) {
+            return avs_errno(AVS_ERANGE);
+        }
+        return AVS_OK;
+    }
 
 public:
-    AvsSocket(const avs_net_socket_configuration_t *config) : channel_() {
+    AvsSocket(const avs_net_socket_configuration_t *config)
+            : stats_(),
+              channel_(stats_),
+              recorder_(CaptureWriter::instance()),
+              capture_id_(),
+              rtt_(),
+              rtt_host_() {
+        if (recorder_) {
+            capture_id_ = recorder_->open_socket(
+                    std::is_same<ChannelType, TcpChannelTag>::value);
+        }
         if (config && config->reuse_addr) {
             channel_.set_reuse_address(true);
         }
+        if (config && config->forced_mtu > 0) {
+            channel_.set_forced_mtu(config->forced_mtu);
+        }
     }
 
     virtual ~AvsSocket() {
@@ -84,117 +185,150 @@ public:
         return channel_.as_selectable_channel();
     }
 
-    virtual void connect(const char *host, const char *port) {
-        channel_.connect(host, port);
+    virtual avs_error_t connect(const char *host, const char *port) {
+        avs_error_t err = channel_.connect(host, port);
+        if (recorder_ && host && port) {
+            const std::string endpoint = std::string(host) + ":" + port;
+            record(CaptureRecordType::CONNECT, err, endpoint.data(),
+                   endpoint.size());
+        }
+        if (host && avs_is_ok(err)) {
+            rtt_host_ = host;
+        }
+        return stats_.record_error(err);
     }
 
-    virtual void send(const void *buffer, size_t buffer_length) {
-        channel_.send(buffer, buffer_length);
+    virtual avs_error_t send(const void *buffer, size_t buffer_length) {
+        ++stats_.send_calls;
+        avs_error_t err = channel_.send(buffer, buffer_length);
+        if (avs_is_ok(err)) {
+            stats_.bytes_sent += buffer_length;
+            if (rtt_) {
+                rtt_->on_send(buffer, buffer_length);
+            }
+        }
+        record(CaptureRecordType::SEND, err, buffer, buffer_length);
+        return stats_.record_error(err);
     }
 
-    virtual void receive(size_t *out_size, void *buffer, size_t buffer_length) {
-        channel_.timeout_respecting_receive(out_size, buffer, buffer_length);
+    virtual avs_error_t
+    receive(size_t *out_size, void *buffer, size_t buffer_length) {
+        ++stats_.receive_calls;
+        avs_error_t err = channel_.timeout_respecting_receive(out_size, buffer,
+                                                              buffer_length);
+        record(CaptureRecordType::RECEIVE, err, buffer,
+               avs_is_ok(err) ? *out_size : 0);
+        if (avs_is_ok(err)) {
+            stats_.bytes_received += *out_size;
+            if (rtt_ && rtt_->on_receive(buffer, *out_size)) {
+                stats_.rtt = rtt_->estimate();
+                if (!rtt_host_.empty()) {
+                    RttRegistry::instance().publish(rtt_host_, stats_.rtt);
+                }
+            }
+        } else if (err.category == AVS_ERRNO_CATEGORY
+                   && err.code == AVS_ETIMEDOUT) {
+            // Routine - anjay_serve() reads until there is no more data.
+            ++stats_.receive_timeouts;
+            return err;
+        }
+        return stats_.record_error(err);
     }
 
-    virtual void bind(const char *localaddr, const char *port) {
+    virtual avs_error_t bind(const char *localaddr, const char *port) {
         channel_.bind(localaddr, port);
+        return AVS_OK;
     }
 
-    virtual void close() {
+    virtual avs_error_t close() {
+        // Also called from the destructor, so that sockets that were not
+        // closed explicitly are not leaked. Record CLOSE only once.
+        const bool was_closed = channel_.is_closed();
         channel_.close();
+        if (!was_closed) {
+            record(CaptureRecordType::CLOSE, AVS_OK);
+        }
+        return AVS_OK;
     }
 
-    virtual void shutdown() {
+    virtual avs_error_t shutdown() {
         channel_.shutdown();
+        return AVS_OK;
     }
 
-    virtual void remote_host(char *out_buffer, size_t out_buffer_size) {
-        auto remote_host = channel_.get_remote_address();
-        if (!remote_host) {
-            avs_throw(SocketError(AVS_EBADF));
-        }
-        if (avs_simple_snprintf(out_buffer, out_buffer_size, "%s",
-                                remote_host->get_host_address().c_str())
-                < 0) {
-            avs_throw(SocketError(AVS_ERANGE));
+    virtual bool has_pending_output() const {
+        return channel_.has_pending_output();
+    }
+
+    virtual avs_error_t flush() {
+        return stats_.record_error(channel_.flush());
+    }
+
+    virtual const SocketStats &stats() const {
+        return stats_;
+    }
+
+    virtual void enable_rtt_estimation() {
+        if (std::is_same<ChannelType, UdpChannelTag>::value && !rtt_) {
+            rtt_.reset(new RttEstimator());
         }
     }
 
-    virtual void remote_hostname(char *out_buffer, size_t out_buffer_size) {
-        auto remote_host = channel_.get_remote_address();
+    virtual avs_error_t remote_host(char *out_buffer, size_t out_buffer_size) {
+        return print_string(out_buffer, out_buffer_size,
+                            channel_.get_remote_host());
+    }
+
+    virtual avs_error_t remote_hostname(char *out_buffer,
+                                        size_t out_buffer_size) {
+        const auto &remote_host = channel_.get_remote_address();
         if (!remote_host) {
-            avs_throw(SocketError(AVS_EBADF));
-        }
-        if (avs_simple_snprintf(out_buffer, out_buffer_size, "%s",
-                                remote_host->get_host_name().c_str())
-                < 0) {
-            avs_throw(SocketError(AVS_ERANGE));
+            return avs_errno(AVS_EBADF);
         }
+        return print_string(out_buffer, out_buffer_size,
+                            remote_host->get_host_name());
     }
 
-    virtual void remote_port(char *out_buffer, size_t out_buffer_size) {
-        auto remote_port = channel_.get_remote_port();
-        if (remote_port < 0) {
-            avs_throw(SocketError(AVS_EBADF));
-        }
-        if (avs_simple_snprintf(out_buffer, out_buffer_size, "%d", remote_port)
-                < 0) {
-            avs_throw(SocketError(AVS_ERANGE));
-        }
+    virtual avs_error_t remote_port(char *out_buffer, size_t out_buffer_size) {
+        return print_port(out_buffer, out_buffer_size,
+                          channel_.get_remote_port());
     }
 
-    virtual void local_host(char *out_buffer, size_t out_buffer_size) {
-        auto local_host = channel_.get_local_address();
-        if (!local_host) {
-            avs_throw(SocketError(AVS_EBADF));
-        }
-        if (avs_simple_snprintf(out_buffer, out_buffer_size, "%s",
-                                local_host->get_host_address().c_str())
-                < 0) {
-            avs_throw(SocketError(AVS_ERANGE));
-        }
+    virtual avs_error_t local_host(char *out_buffer, size_t out_buffer_size) {
+        return print_string(out_buffer, out_buffer_size,
+                            channel_.get_local_host());
     }
 
-    virtual void local_port(char *out_buffer, size_t out_buffer_size) {
-        auto local_port = channel_.get_local_port();
-        if (local_port < 0) {
-            avs_throw(SocketError(AVS_EBADF));
-        }
-        if (avs_simple_snprintf(out_buffer, out_buffer_size, "%d", local_port)
-                < 0) {
-            avs_throw(SocketError(AVS_ERANGE));
-        }
+    virtual avs_error_t local_port(char *out_buffer, size_t out_buffer_size) {
+        return print_port(out_buffer, out_buffer_size,
+                          channel_.get_local_port());
     }
 
-    virtual void get_opt(avs_net_socket_opt_key_t option_key,
-                         avs_net_socket_opt_value_t *out_option_value) {
+    virtual avs_error_t get_opt(avs_net_socket_opt_key_t option_key,
+                                avs_net_socket_opt_value_t *out_option_value) {
         switch (option_key) {
         case AVS_NET_SOCKET_OPT_STATE:
             out_option_value->state = channel_.get_state();
-            break;
+            return AVS_OK;
         case AVS_NET_SOCKET_OPT_INNER_MTU:
-            out_option_value->mtu = channel_.get_inner_mtu();
-            break;
+            return channel_.get_inner_mtu(&out_option_value->mtu);
         case AVS_NET_SOCKET_OPT_RECV_TIMEOUT:
             out_option_value->recv_timeout = channel_.get_timeout();
-            break;
+            return AVS_OK;
         default:
-            avs_throw(SocketError(
-                    AVS_EINVAL,
-                    "get_opt_net: unknown or unsupported option key"));
+            // unknown or unsupported option key
+            return avs_errno(AVS_EINVAL);
         }
     }
 
-    virtual void set_opt(avs_net_socket_opt_key_t option_key,
-                         avs_net_socket_opt_value_t option_value) {
+    virtual avs_error_t set_opt(avs_net_socket_opt_key_t option_key,
+                                avs_net_socket_opt_value_t option_value) {
         switch (option_key) {
         case AVS_NET_SOCKET_OPT_RECV_TIMEOUT:
-            channel_.set_timeout(option_value.recv_timeout);
-            break;
+            return channel_.set_timeout(option_value.recv_timeout);
         default:
-            avs_throw(SocketError(
-                    AVS_EINVAL,
-                    "set_opt_net: unknown or unsupported option key"));
+            // unknown or unsupported option key
+            return avs_errno(AVS_EINVAL);
         }
     }
 };
@@ -30,6 +30,7 @@
 #include "../jni_wrapper.hpp"
 
 #include "./avs_net_socket.hpp"
+#include "./replay_socket.hpp"
 #include "./socket_error.hpp"
 
 #include "../util_classes/exception.hpp"
@@ -46,8 +47,10 @@ struct avs_net_socket_struct {
 namespace compat {
 
 namespace {
+// NOTE: Socket operations report routine failures through their return
+// values. Exceptions caught here indicate actual bugs or JVM failures.
 template <typename F>
-auto call_exception_safe(const std::string &name, F &&callback) noexcept try {
+auto call_exception_safe(const char *name, F &&callback) noexcept try {
     if constexpr (std::is_same<decltype(callback()), void>::value) {
         callback();
         return AVS_OK;
@@ -55,12 +58,12 @@ auto call_exception_safe(const std::string &name, F &&callback) noexcept try {
         return callback();
     }
 } catch (SocketError &e) {
-    LOG(DEBUG, "could not perform %s: %s", name.c_str(), e.what());
+    LOG(DEBUG, "could not perform %s: %s", name, e.what());
     return avs_errno(e.error());
 } catch (...) {
     avs_log_and_clear_exception(ERROR);
     LOG(ERROR, "the above exception happened while attempting to perform %s",
-        name.c_str());
+        name);
     return avs_errno(AVS_EIO);
 }
 } // namespace
@@ -73,7 +76,7 @@ AvsSocketBase *get_impl(avs_net_socket_t *socket) {
 avs_error_t
 connect_net(avs_net_socket_t *net_socket, const char *host, const char *port) {
     return call_exception_safe("connect()", [=]() {
-        get_impl(net_socket)->connect(host, port);
+        return get_impl(net_socket)->connect(host, port);
     });
 }
 
@@ -81,7 +84,7 @@ avs_error_t send_net(avs_net_socket_t *net_socket,
                      const void *buffer,
                      size_t buffer_length) {
     return call_exception_safe("send()", [=]() {
-        get_impl(net_socket)->send(buffer, buffer_length);
+        return get_impl(net_socket)->send(buffer, buffer_length);
     });
 }
 
@@ -95,7 +98,7 @@ avs_error_t receive_net(avs_net_socket_t *net_socket,
                         void *buffer,
                         size_t buffer_length) {
     return call_exception_safe("receive()", [=]() {
-        get_impl(net_socket)->receive(out_size, buffer, buffer_length);
+        return get_impl(net_socket)->receive(out_size, buffer, buffer_length);
     });
 }
 
@@ -114,7 +117,7 @@ avs_error_t bind_net(avs_net_socket_t *net_socket,
                      const char *localaddr,
                      const char *port) {
     return call_exception_safe("bind()", [=]() {
-        get_impl(net_socket)->bind(localaddr, port);
+        return get_impl(net_socket)->bind(localaddr, port);
     });
 }
 
@@ -123,19 +126,20 @@ avs_error_t accept_net(avs_net_socket_t *, avs_net_socket_t *) {
 }
 
 avs_error_t close_net(avs_net_socket_t *net_socket) {
-    return call_exception_safe("close()",
-                               [=]() { get_impl(net_socket)->close(); });
+    return call_exception_safe(
+            "close()", [=]() { return get_impl(net_socket)->close(); });
 }
 
 avs_error_t shutdown_net(avs_net_socket_t *net_socket) {
     return call_exception_safe("shutdown()", [=]() {
         avs_net_socket_opt_value_t value{};
-        get_impl(net_socket)->get_opt(AVS_NET_SOCKET_OPT_STATE, &value);
-
-        if (value.state != AVS_NET_SOCKET_STATE_CLOSED
+        avs_error_t err = get_impl(net_socket)->get_opt(
+                AVS_NET_SOCKET_OPT_STATE, &value);
+        if (avs_is_ok(err) && value.state != AVS_NET_SOCKET_STATE_CLOSED
                 && value.state != AVS_NET_SOCKET_STATE_SHUTDOWN) {
-            get_impl(net_socket)->shutdown();
+            err = get_impl(net_socket)->shutdown();
         }
+        return err;
     });
 }
 
@@ -155,7 +159,7 @@ avs_error_t remote_host_net(avs_net_socket_t *net_socket,
                             char *out_buffer,
                             size_t out_buffer_size) {
     return call_exception_safe("remote_host()", [=]() {
-        get_impl(net_socket)->remote_host(out_buffer, out_buffer_size);
+        return get_impl(net_socket)->remote_host(out_buffer, out_buffer_size);
     });
 }
 
@@ -163,7 +167,8 @@ avs_error_t remote_hostname_net(avs_net_socket_t *net_socket,
                                 char *out_buffer,
                                 size_t out_buffer_size) {
     return call_exception_safe("remote_hostname()", [=]() {
-        get_impl(net_socket)->remote_hostname(out_buffer, out_buffer_size);
+        return get_impl(net_socket)->remote_hostname(out_buffer,
+                                                     out_buffer_size);
     });
 }
 
@@ -171,7 +176,7 @@ avs_error_t remote_port_net(avs_net_socket_t *net_socket,
                             char *out_buffer,
                             size_t out_buffer_size) {
     return call_exception_safe("remote_port()", [=]() {
-        get_impl(net_socket)->remote_port(out_buffer, out_buffer_size);
+        return get_impl(net_socket)->remote_port(out_buffer, out_buffer_size);
     });
 }
 
@@ -179,7 +184,7 @@ avs_error_t local_host_net(avs_net_socket_t *net_socket,
                            char *out_buffer,
                            size_t out_buffer_size) {
     return call_exception_safe("local_host()", [=]() {
-        get_impl(net_socket)->local_host(out_buffer, out_buffer_size);
+        return get_impl(net_socket)->local_host(out_buffer, out_buffer_size);
     });
 }
 
@@ -187,7 +192,7 @@ avs_error_t local_port_net(avs_net_socket_t *net_socket,
                            char *out_buffer,
                            size_t out_buffer_size) {
     return call_exception_safe("local_port()", [=]() {
-        get_impl(net_socket)->local_port(out_buffer, out_buffer_size);
+        return get_impl(net_socket)->local_port(out_buffer, out_buffer_size);
     });
 }
 
@@ -195,7 +200,7 @@ avs_error_t get_opt_net(avs_net_socket_t *net_socket,
                         avs_net_socket_opt_key_t option_key,
                         avs_net_socket_opt_value_t *out_option_value) {
     return call_exception_safe("get_opt()", [=]() {
-        get_impl(net_socket)->get_opt(option_key, out_option_value);
+        return get_impl(net_socket)->get_opt(option_key, out_option_value);
     });
 }
 
@@ -203,10 +208,25 @@ avs_error_t set_opt_net(avs_net_socket_t *net_socket,
                         avs_net_socket_opt_key_t option_key,
                         avs_net_socket_opt_value_t option_value) {
     return call_exception_safe("set_opt()", [=]() {
-        get_impl(net_socket)->set_opt(option_key, option_value);
+        return get_impl(net_socket)->set_opt(option_key, option_value);
     });
 }
 
+avs_error_t flush_pending_output(avs_net_socket_t *socket) {
+    return call_exception_safe("flush()", [=]() {
+        return const_cast<AvsSocketBase *>(
+                       reinterpret_cast<const AvsSocketBase *>(
+                               avs_net_socket_get_system(socket)))
+                ->flush();
+    });
+}
+
+void enable_rtt_estimation(avs_net_socket_t *socket) {
+    const_cast<AvsSocketBase *>(reinterpret_cast<const AvsSocketBase *>(
+                                        avs_net_socket_get_system(socket)))
+            ->enable_rtt_estimation();
+}
+
 const avs_net_socket_v_table_t NET_VTABLE = ([]() {
     avs_net_socket_v_table_t res{};
     res.connect = connect_net;
@@ -256,10 +276,6 @@ int ensure_supported_configuration(
         LOG(ERROR, "Setting address family is not supported yet");
         return -1;
     }
-    if (config->forced_mtu) {
-        LOG(ERROR, "Setting forced MTU is not supported yet");
-        return -1;
-    }
     if (config->preferred_family) {
         LOG(ERROR, "Setting preferred family is not supported yet");
         return -1;
@@ -305,6 +321,10 @@ extern "C" {
 avs_error_t _avs_net_create_tcp_socket(avs_net_socket_t **socket,
                                        const void *socket_configuration) {
     return compat::call_exception_safe("_avs_net_create_tcp_socket()", [=]() {
+        if (compat::CaptureReader::instance()) {
+            return compat::create_net_socket<compat::ReplaySocket>(
+                    socket, socket_configuration);
+        }
         return compat::create_net_socket<
                 compat::AvsSocket<compat::TcpChannelTag>>(socket,
                                                           socket_configuration);
@@ -314,6 +334,10 @@ avs_error_t _avs_net_create_tcp_socket(avs_net_socket_t **socket,
 avs_error_t _avs_net_create_udp_socket(avs_net_socket_t **socket,
                                        const void *socket_configuration) {
     return compat::call_exception_safe("_avs_net_create_udp_socket()", [=]() {
+        if (compat::CaptureReader::instance()) {
+            return compat::create_net_socket<compat::ReplaySocket>(
+                    socket, socket_configuration);
+        }
         return compat::create_net_socket<
                 compat::AvsSocket<compat::UdpChannelTag>>(socket,
                                                           socket_configuration);
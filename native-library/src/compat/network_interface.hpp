@@ -0,0 +1,61 @@
+/*
+ * Copyright 2020-2024 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "../jni_wrapper.hpp"
+
+#include <optional>
+
+#include "../util_classes/accessor_base.hpp"
+#include "../util_classes/exception.hpp"
+#include "./socket_address.hpp"
+
+namespace compat {
+
+struct NetworkInterface {
+    static constexpr auto Name() {
+        return "java/net/NetworkInterface";
+    }
+
+    /**
+     * Returns MTU of the network interface that has @p address assigned, or
+     * an empty optional if there is no such interface or its MTU is unknown.
+     */
+    static std::optional<int> get_mtu_by_address(const InetAddress &address) {
+        try {
+            auto iface = utils::AccessorBase<NetworkInterface>::
+                    get_static_method<jni::Object<NetworkInterface>(
+                            jni::Object<InetAddress>)>("getByInetAddress")(
+                            address.into_java());
+            if (!iface) {
+                return {};
+            }
+            const int mtu =
+                    utils::AccessorBase<NetworkInterface>{ iface }
+                            .get_method<jni::jint()>("getMTU")();
+            if (mtu <= 0) {
+                return {};
+            }
+            return { mtu };
+        } catch (jni::PendingJavaException &) {
+            avs_log_and_clear_exception(DEBUG);
+            return {};
+        }
+    }
+};
+
+} // namespace compat
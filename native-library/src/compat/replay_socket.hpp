@@ -0,0 +1,298 @@
+/*
+ * Copyright 2020-2024 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <avsystem/commons/avs_errno.h>
+#include <avsystem/commons/avs_socket.h>
+#include <avsystem/commons/avs_utils.h>
+
+#include "../jni_wrapper.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../global_context.hpp"
+#include "../util_classes/accessor_base.hpp"
+#include "../util_classes/byte_buffer.hpp"
+#include "../util_classes/selectable_channel.hpp"
+#include "./avs_net_socket.hpp"
+#include "./traffic_capture.hpp"
+
+namespace compat {
+
+/**
+ * Socket that does not touch the network, but feeds back data recorded by
+ * CaptureWriter instead, as fast as it is requested. Whatever is sent is
+ * counted and discarded. On UDP sockets, tokens and message IDs of the
+ * replayed datagrams are rewritten to match what the client actually sent
+ * (see CoapExchangeMapper).
+ *
+ * The event loop needs something to select() on, so each socket owns a
+ * java.nio.channels.Pipe: a single byte is kept in it for as long as there is
+ * recorded data left to receive, making the source end readable.
+ */
+class ReplaySocket final : public AvsSocketBase {
+    struct Pipe {
+        static constexpr auto Name() {
+            return "java/nio/channels/Pipe";
+        }
+    };
+
+    struct SourceChannel {
+        static constexpr auto Name() {
+            return "java/nio/channels/Pipe$SourceChannel";
+        }
+    };
+
+    struct SinkChannel {
+        static constexpr auto Name() {
+            return "java/nio/channels/Pipe$SinkChannel";
+        }
+    };
+
+    std::shared_ptr<CaptureReader> reader_;
+    uint32_t id_;
+    bool tcp_;
+    CoapExchangeMapper mapper_;
+    jni::Global<jni::Object<SourceChannel>> source_;
+    jni::Global<jni::Object<SinkChannel>> sink_;
+    utils::ByteBuffer wakeup_;
+    bool readable_;
+    avs_net_socket_state_t state_;
+    avs_time_duration_t timeout_;
+    std::string remote_host_;
+    std::string remote_port_;
+    SocketStats stats_;
+
+    /**
+     * Makes the source end of the pipe readable if and only if there is more
+     * recorded data to receive.
+     */
+    void update_readiness() {
+        const bool should_be_readable = state_ == AVS_NET_SOCKET_STATE_CONNECTED
+                                        && reader_->has_receive(id_);
+        if (should_be_readable == readable_) {
+            return;
+        }
+        wakeup_.rewind();
+        if (should_be_readable) {
+            utils::AccessorBase<SinkChannel>{ sink_ }
+                    .get_method<jni::jint(jni::Object<utils::ByteBuffer>)>(
+                            "write")(wakeup_.into_java());
+        } else {
+            utils::AccessorBase<SourceChannel>{ source_ }
+                    .get_method<jni::jint(jni::Object<utils::ByteBuffer>)>(
+                            "read")(wakeup_.into_java());
+        }
+        readable_ = should_be_readable;
+    }
+
+    static avs_error_t print(char *out_buffer,
+                             size_t out_buffer_size,
+                             const std::string &value) {
+        if (avs_simple_snprintf(out_buffer, out_buffer_size, "%s",
+                                value.c_str())
+                < 0) {
+            return avs_errno(AVS_ERANGE);
+        }
+        return AVS_OK;
+    }
+
+public:
+    ReplaySocket(const avs_net_socket_configuration_t *)
+            : reader_(CaptureReader::instance()),
+              id_(reader_->open_socket()),
+              tcp_(reader_->is_tcp(id_)),
+              mapper_(),
+              source_(),
+              sink_(),
+              wakeup_(1),
+              readable_(false),
+              state_(AVS_NET_SOCKET_STATE_CLOSED),
+              timeout_(AVS_NET_SOCKET_DEFAULT_RECV_TIMEOUT),
+              remote_host_(),
+              remote_port_(),
+              stats_() {
+        GlobalContext::call_with_env([&](auto &&env) {
+            auto pipe = utils::AccessorBase<Pipe>::get_static_method<
+                    jni::Object<Pipe>()>("open")();
+            auto accessor = utils::AccessorBase<Pipe>{ pipe };
+            source_ = jni::NewGlobal(
+                    *env,
+                    accessor.get_method<jni::Object<SourceChannel>()>(
+                            "source")());
+            sink_ = jni::NewGlobal(
+                    *env,
+                    accessor.get_method<jni::Object<SinkChannel>()>("sink")());
+        });
+        utils::AccessorBase<SourceChannel>{ source_ }
+                .get_method<jni::Object<utils::SelectableChannel>(
+                        jni::jboolean)>("configureBlocking")(false);
+    }
+
+    virtual ~ReplaySocket() {
+        utils::AccessorBase<SourceChannel>{ source_ }.get_method<void()>(
+                "close")();
+        utils::AccessorBase<SinkChannel>{ sink_ }.get_method<void()>("close")();
+    }
+
+    virtual jni::Local<jni::Object<utils::SelectableChannel>>
+    selectable_channel() const {
+        return GlobalContext::call_with_env([&](auto &&env) {
+            return jni::Cast<utils::SelectableChannel>(
+                    *env, jni::Class<utils::SelectableChannel>::Find(*env),
+                    source_);
+        });
+    }
+
+    virtual avs_error_t connect(const char *host, const char *port) {
+        if (!host || !port) {
+            return avs_errno(AVS_EINVAL);
+        }
+        remote_host_ = host;
+        remote_port_ = port;
+        state_ = AVS_NET_SOCKET_STATE_CONNECTED;
+        update_readiness();
+        return AVS_OK;
+    }
+
+    virtual avs_error_t send(const void *buffer, size_t buffer_length) {
+        if (state_ != AVS_NET_SOCKET_STATE_CONNECTED) {
+            return stats_.record_error(avs_errno(AVS_ENOTCONN));
+        }
+        std::vector<char> recorded;
+        if (!tcp_ && reader_->next_send(id_, &recorded)) {
+            mapper_.on_send(recorded, buffer, buffer_length);
+        }
+        ++stats_.send_calls;
+        stats_.bytes_sent += buffer_length;
+        return AVS_OK;
+    }
+
+    virtual avs_error_t
+    receive(size_t *out_size, void *buffer, size_t buffer_length) {
+        if (state_ != AVS_NET_SOCKET_STATE_CONNECTED) {
+            return stats_.record_error(avs_errno(AVS_ENOTCONN));
+        }
+        ++stats_.receive_calls;
+        CaptureReader::Receive record;
+        if (!reader_->next_receive(id_, &record)) {
+            ++stats_.receive_timeouts;
+            return avs_errno(AVS_ETIMEDOUT);
+        }
+        update_readiness();
+        if (record.status) {
+            if (record.status == AVS_ETIMEDOUT) {
+                ++stats_.receive_timeouts;
+                return avs_errno(AVS_ETIMEDOUT);
+            }
+            return stats_.record_error(avs_errno(record.status));
+        }
+        if (!tcp_) {
+            mapper_.rewrite(record.data);
+        }
+        *out_size = std::min(buffer_length, record.data.size());
+        memcpy(buffer, record.data.data(), *out_size);
+        stats_.bytes_received += *out_size;
+        return AVS_OK;
+    }
+
+    virtual avs_error_t bind(const char *, const char *) {
+        if (state_ == AVS_NET_SOCKET_STATE_CLOSED) {
+            state_ = AVS_NET_SOCKET_STATE_BOUND;
+        }
+        return AVS_OK;
+    }
+
+    virtual avs_error_t close() {
+        state_ = AVS_NET_SOCKET_STATE_CLOSED;
+        update_readiness();
+        return AVS_OK;
+    }
+
+    virtual avs_error_t shutdown() {
+        state_ = AVS_NET_SOCKET_STATE_SHUTDOWN;
+        update_readiness();
+        return AVS_OK;
+    }
+
+    virtual avs_error_t remote_host(char *out_buffer, size_t out_buffer_size) {
+        return print(out_buffer, out_buffer_size, remote_host_);
+    }
+
+    virtual avs_error_t remote_hostname(char *out_buffer,
+                                        size_t out_buffer_size) {
+        return print(out_buffer, out_buffer_size, remote_host_);
+    }
+
+    virtual avs_error_t remote_port(char *out_buffer, size_t out_buffer_size) {
+        return print(out_buffer, out_buffer_size, remote_port_);
+    }
+
+    virtual avs_error_t local_host(char *out_buffer, size_t out_buffer_size) {
+        return print(out_buffer, out_buffer_size, "0.0.0.0");
+    }
+
+    virtual avs_error_t local_port(char *out_buffer, size_t out_buffer_size) {
+        return print(out_buffer, out_buffer_size, "0");
+    }
+
+    virtual avs_error_t get_opt(avs_net_socket_opt_key_t option_key,
+                                avs_net_socket_opt_value_t *out_option_value) {
+        switch (option_key) {
+        case AVS_NET_SOCKET_OPT_STATE:
+            out_option_value->state = state_;
+            return AVS_OK;
+        case AVS_NET_SOCKET_OPT_INNER_MTU:
+            out_option_value->mtu = 1232; /* 1280 - (40 for IPv6 + 8 for UDP) */
+            return AVS_OK;
+        case AVS_NET_SOCKET_OPT_RECV_TIMEOUT:
+            out_option_value->recv_timeout = timeout_;
+            return AVS_OK;
+        default:
+            return avs_errno(AVS_EINVAL);
+        }
+    }
+
+    virtual avs_error_t set_opt(avs_net_socket_opt_key_t option_key,
+                                avs_net_socket_opt_value_t option_value) {
+        switch (option_key) {
+        case AVS_NET_SOCKET_OPT_RECV_TIMEOUT:
+            timeout_ = option_value.recv_timeout;
+            return AVS_OK;
+        default:
+            return avs_errno(AVS_EINVAL);
+        }
+    }
+
+    virtual bool has_pending_output() const {
+        return false;
+    }
+
+    virtual avs_error_t flush() {
+        return AVS_OK;
+    }
+
+    virtual const SocketStats &stats() const {
+        return stats_;
+    }
+};
+
+} // namespace compat
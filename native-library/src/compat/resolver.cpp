@@ -0,0 +1,146 @@
+/*
+ * Copyright 2020-2024 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "./resolver.hpp"
+
+#include <avsystem/commons/avs_log.h>
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#include "../global_context.hpp"
+#include "../util_classes/exception.hpp"
+#include "./socket_address.hpp"
+
+namespace compat {
+
+namespace {
+
+Resolver::Addresses java_lookup(const std::string &host) {
+    // Keep the worker thread attached for the whole lookup, so that the
+    // exception is still pending when it gets logged.
+    return GlobalContext::call_with_env([&](auto &&) -> Resolver::Addresses {
+        try {
+            Resolver::Addresses result;
+            for (const auto &address : InetAddress::get_all_by_name(host)) {
+                result.push_back(address.get_address());
+            }
+            return result;
+        } catch (jni::PendingJavaException &) {
+            avs_log_and_clear_exception(DEBUG);
+            return {};
+        }
+    });
+}
+
+} // namespace
+
+Resolver::Resolver()
+        : mutex_(),
+          lookup_(java_lookup),
+          cache_ttl_(DEFAULT_CACHE_TTL),
+          generation_(),
+          cache_(),
+          pending_() {}
+
+Resolver &Resolver::instance() {
+    static Resolver resolver;
+    return resolver;
+}
+
+avs_error_t Resolver::resolve(const std::string &host,
+                              avs_time_duration_t timeout,
+                              std::shared_ptr<const Addresses> *out_addresses) {
+    PendingLookup lookup;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto cached = cache_.find(host);
+        if (cached != cache_.end()) {
+            if (avs_time_monotonic_before(avs_time_monotonic_now(),
+                                          cached->second.expires)) {
+                *out_addresses = cached->second.addresses;
+                return AVS_OK;
+            }
+            cache_.erase(cached);
+        }
+        auto pending = pending_.find(host);
+        lookup = pending != pending_.end() ? pending->second
+                                           : start_lookup(host);
+    }
+
+    int64_t timeout_ms;
+    if (avs_time_duration_to_scalar(&timeout_ms, AVS_TIME_MS, timeout)) {
+        lookup.wait();
+    } else if (lookup.wait_for(std::chrono::milliseconds(
+                       std::max<int64_t>(timeout_ms, 0)))
+               != std::future_status::ready) {
+        return avs_errno(AVS_ETIMEDOUT);
+    }
+    auto result = lookup.get();
+    if (!result || result->empty()) {
+        return avs_errno(AVS_EADDRNOTAVAIL);
+    }
+    *out_addresses = std::move(result);
+    return AVS_OK;
+}
+
+void Resolver::set_lookup_function(LookupFunction lookup,
+                                   avs_time_duration_t cache_ttl) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    lookup_ = lookup ? std::move(lookup) : LookupFunction(java_lookup);
+    cache_ttl_ = cache_ttl;
+    ++generation_;
+    cache_.clear();
+    pending_.clear();
+}
+
+Resolver::PendingLookup Resolver::start_lookup(const std::string &host) {
+    auto promise = std::make_shared<
+            std::promise<std::shared_ptr<const Addresses>>>();
+    PendingLookup result = promise->get_future().share();
+    pending_.emplace(host, result);
+
+    std::thread([this, host, promise, lookup = lookup_, ttl = cache_ttl_,
+                 generation = generation_]() {
+        std::shared_ptr<const Addresses> addresses;
+        try {
+            addresses = std::make_shared<const Addresses>(lookup(host));
+        } catch (std::exception &e) {
+            avs_log(resolver, WARNING, "could not resolve %s: %s",
+                    host.c_str(), e.what());
+        } catch (...) {
+            avs_log(resolver, WARNING, "could not resolve %s", host.c_str());
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (generation == generation_) {
+                pending_.erase(host);
+                if (addresses && !addresses->empty()) {
+                    cache_[host] = CacheEntry{
+                        addresses,
+                        avs_time_monotonic_add(avs_time_monotonic_now(), ttl)
+                    };
+                }
+            }
+        }
+        promise->set_value(std::move(addresses));
+    })
+            .detach();
+    return result;
+}
+
+} // namespace compat
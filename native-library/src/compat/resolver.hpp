@@ -0,0 +1,96 @@
+/*
+ * Copyright 2020-2024 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "../jni_wrapper.hpp"
+
+#include <avsystem/commons/avs_errno.h>
+#include <avsystem/commons/avs_time.h>
+
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace compat {
+
+/**
+ * Resolves host names on worker threads and caches the results, so that
+ * reconnects and downloads to the same host do not hit the resolver each time,
+ * and a slow resolver cannot block the Anjay thread indefinitely.
+ *
+ * Addresses are kept in their raw form (as returned by
+ * InetAddress.getAddress()) rather than as Java objects, so that no references
+ * are shared between the worker threads and the Anjay thread.
+ */
+class Resolver {
+public:
+    typedef std::vector<std::vector<jni::jbyte>> Addresses;
+    typedef std::function<Addresses(const std::string &)> LookupFunction;
+
+    static constexpr avs_time_duration_t DEFAULT_CACHE_TTL{ 60, 0 };
+
+    static Resolver &instance();
+
+    /**
+     * Fetches addresses of @p host into @p out_addresses, waiting at most
+     * @p timeout for the lookup to finish. A lookup that does not finish in
+     * time continues in the background, and its result is cached for
+     * subsequent calls.
+     *
+     * @returns AVS_OK on success, AVS_ETIMEDOUT on timeout, or
+     *          AVS_EADDRNOTAVAIL if @p host could not be resolved.
+     */
+    avs_error_t resolve(const std::string &host,
+                        avs_time_duration_t timeout,
+                        std::shared_ptr<const Addresses> *out_addresses);
+
+    /**
+     * Replaces the function used to perform lookups, e.g. with a stub in
+     * tests, and the time for which its results are cached. Drops all cached
+     * results. An empty @p lookup restores lookups through InetAddress.
+     */
+    void set_lookup_function(LookupFunction lookup,
+                             avs_time_duration_t cache_ttl);
+
+private:
+    typedef std::shared_future<std::shared_ptr<const Addresses>> PendingLookup;
+
+    struct CacheEntry {
+        std::shared_ptr<const Addresses> addresses;
+        avs_time_monotonic_t expires;
+    };
+
+    std::mutex mutex_;
+    LookupFunction lookup_;
+    avs_time_duration_t cache_ttl_;
+    // Incremented whenever the cache is dropped, so that lookups started
+    // before that do not populate it with stale results.
+    uint64_t generation_;
+    std::unordered_map<std::string, CacheEntry> cache_;
+    std::unordered_map<std::string, PendingLookup> pending_;
+
+    Resolver();
+
+    PendingLookup start_lookup(const std::string &host);
+};
+
+} // namespace compat
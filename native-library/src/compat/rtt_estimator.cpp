@@ -0,0 +1,168 @@
+/*
+ * Copyright 2020-2024 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "./rtt_estimator.hpp"
+
+#include <avsystem/commons/avs_url.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+
+namespace compat {
+
+namespace {
+
+enum class CoapType : uint8_t { CONFIRMABLE = 0, ACK = 2, RESET = 3 };
+
+constexpr size_t COAP_HEADER_SIZE = 4;
+constexpr uint8_t COAP_VERSION = 1;
+
+// Bounds and clock granularity as recommended by RFC 6298.
+constexpr int64_t MIN_RTO_US = 1000000;
+constexpr int64_t MAX_RTO_US = 60000000;
+constexpr int64_t CLOCK_GRANULARITY_US = 1000;
+
+bool parse_header(const void *data,
+                  size_t length,
+                  CoapType *out_type,
+                  uint16_t *out_message_id) {
+    const uint8_t *bytes = static_cast<const uint8_t *>(data);
+    if (length < COAP_HEADER_SIZE || (bytes[0] >> 6) != COAP_VERSION) {
+        return false;
+    }
+    *out_type = static_cast<CoapType>((bytes[0] >> 4) & 0x03);
+    *out_message_id = static_cast<uint16_t>((bytes[2] << 8) | bytes[3]);
+    return true;
+}
+
+int64_t to_us(avs_time_duration_t duration) {
+    int64_t result = 0;
+    avs_time_duration_to_scalar(&result, AVS_TIME_US, duration);
+    return result;
+}
+
+} // namespace
+
+void RttEstimator::on_send(const void *data, size_t length) {
+    CoapType type;
+    uint16_t message_id;
+    if (!parse_header(data, length, &type, &message_id)
+            || type != CoapType::CONFIRMABLE) {
+        return;
+    }
+    auto it = std::find_if(pending_.begin(), pending_.end(),
+                           [&](const Exchange &exchange) {
+                               return exchange.message_id == message_id;
+                           });
+    if (it != pending_.end()) {
+        it->retransmitted = true;
+        return;
+    }
+    if (pending_.size() >= MAX_PENDING_EXCHANGES) {
+        pending_.erase(pending_.begin());
+    }
+    pending_.push_back(Exchange{ message_id, avs_time_monotonic_now(), false });
+}
+
+bool RttEstimator::on_receive(const void *data, size_t length) {
+    CoapType type;
+    uint16_t message_id;
+    if (!parse_header(data, length, &type, &message_id)
+            || (type != CoapType::ACK && type != CoapType::RESET)) {
+        return false;
+    }
+    auto it = std::find_if(pending_.begin(), pending_.end(),
+                           [&](const Exchange &exchange) {
+                               return exchange.message_id == message_id;
+                           });
+    if (it == pending_.end()) {
+        return false;
+    }
+    const Exchange exchange = *it;
+    pending_.erase(it);
+    if (exchange.retransmitted) {
+        return false;
+    }
+    add_sample(avs_time_monotonic_diff(avs_time_monotonic_now(),
+                                       exchange.sent));
+    return true;
+}
+
+void RttEstimator::add_sample(avs_time_duration_t rtt) {
+    const int64_t rtt_us = to_us(rtt);
+    int64_t srtt_us;
+    int64_t rttvar_us;
+    if (!estimate_.samples) {
+        srtt_us = rtt_us;
+        rttvar_us = rtt_us / 2;
+    } else {
+        srtt_us = to_us(estimate_.smoothed_rtt);
+        rttvar_us = to_us(estimate_.rtt_variation);
+        rttvar_us = (3 * rttvar_us + std::llabs(srtt_us - rtt_us)) / 4;
+        srtt_us = (7 * srtt_us + rtt_us) / 8;
+    }
+    int64_t rto_us = srtt_us + std::max(CLOCK_GRANULARITY_US, 4 * rttvar_us);
+    rto_us = std::min(std::max(rto_us, MIN_RTO_US), MAX_RTO_US);
+
+    ++estimate_.samples;
+    estimate_.smoothed_rtt =
+            avs_time_duration_from_scalar(srtt_us, AVS_TIME_US);
+    estimate_.rtt_variation =
+            avs_time_duration_from_scalar(rttvar_us, AVS_TIME_US);
+    estimate_.retransmission_timeout =
+            avs_time_duration_from_scalar(rto_us, AVS_TIME_US);
+}
+
+avs_coap_udp_tx_params_t
+RttEstimator::adapt(const avs_coap_udp_tx_params_t &base,
+                    const RttEstimate &estimate) {
+    avs_coap_udp_tx_params_t result = base;
+    if (estimate.samples) {
+        result.ack_timeout = estimate.retransmission_timeout;
+    }
+    return result;
+}
+
+RttRegistry &RttRegistry::instance() {
+    static RttRegistry registry;
+    return registry;
+}
+
+void RttRegistry::publish(const std::string &host,
+                          const RttEstimate &estimate) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    estimates_[host] = estimate;
+}
+
+avs_coap_udp_tx_params_t
+RttRegistry::tx_params_for_url(const avs_coap_udp_tx_params_t &base,
+                               const char *url) {
+    if (!url) {
+        return base;
+    }
+    std::unique_ptr<avs_url_t, decltype(&avs_url_free)> parsed(
+            avs_url_parse_lenient(url), avs_url_free);
+    if (!parsed || !avs_url_host(parsed.get())) {
+        return base;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = estimates_.find(avs_url_host(parsed.get()));
+    return it == estimates_.end() ? base
+                                  : RttEstimator::adapt(base, it->second);
+}
+
+} // namespace compat
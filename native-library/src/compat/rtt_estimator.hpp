@@ -0,0 +1,107 @@
+/*
+ * Copyright 2020-2024 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <avsystem/coap/udp.h>
+#include <avsystem/commons/avs_time.h>
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "./socket_stats.hpp"
+
+namespace compat {
+
+/**
+ * Estimates the round-trip time of confirmable CoAP exchanges on a single UDP
+ * socket, by matching outgoing Confirmable messages with incoming ACK or Reset
+ * messages by their Message ID.
+ *
+ * Only plain CoAP can be inspected - (D)TLS records do not parse as CoAP
+ * messages and are ignored. Samples are never taken from retransmitted
+ * exchanges, as it is not known which transmission got acknowledged (Karn's
+ * algorithm).
+ */
+class RttEstimator {
+public:
+    RttEstimator() : estimate_(), pending_() {}
+
+    void on_send(const void *data, size_t length);
+
+    /**
+     * @returns true if @p data completed an exchange and the estimate has been
+     *          updated.
+     */
+    bool on_receive(const void *data, size_t length);
+
+    const RttEstimate &estimate() const {
+        return estimate_;
+    }
+
+    /**
+     * Returns @p base with ACK_TIMEOUT replaced by the retransmission timeout
+     * from @p estimate, or @p base unchanged if there are no samples yet.
+     */
+    static avs_coap_udp_tx_params_t
+    adapt(const avs_coap_udp_tx_params_t &base, const RttEstimate &estimate);
+
+private:
+    struct Exchange {
+        uint16_t message_id;
+        avs_time_monotonic_t sent;
+        bool retransmitted;
+    };
+
+    // Anjay waits for each exchange to finish before starting another one
+    // (NSTART = 1), so this only needs to cover a few concurrent ones.
+    static constexpr size_t MAX_PENDING_EXCHANGES = 16;
+
+    RttEstimate estimate_;
+    std::vector<Exchange> pending_;
+
+    void add_sample(avs_time_duration_t rtt);
+};
+
+/**
+ * Process-wide store of the most recent RTT estimates, keyed by the host name
+ * the socket was connected to. Only sockets of clients with adaptive tx params
+ * enabled measure RTT and publish their estimates here.
+ */
+class RttRegistry {
+public:
+    static RttRegistry &instance();
+
+    void publish(const std::string &host, const RttEstimate &estimate);
+
+    /**
+     * Returns @p base adapted to the estimate for the host of @p url, or
+     * @p base unchanged if no estimate for that host is known.
+     */
+    avs_coap_udp_tx_params_t tx_params_for_url(
+            const avs_coap_udp_tx_params_t &base, const char *url);
+
+private:
+    std::mutex mutex_;
+    std::unordered_map<std::string, RttEstimate> estimates_;
+
+    RttRegistry() : mutex_(), estimates_() {}
+};
+
+} // namespace compat
@@ -21,6 +21,7 @@
 
 #include <cstring>
 #include <string>
+#include <vector>
 
 namespace compat {
 
@@ -48,7 +49,7 @@ public:
                 [&](auto &&env) { return jni::NewLocal(*env, self_); });
     }
 
-    std::string get_host_address() {
+    std::string get_host_address() const {
         return GlobalContext::call_with_env([&](auto &&env) {
             return jni::Make<std::string>(
                     *env,
@@ -57,7 +58,7 @@ public:
         });
     }
 
-    std::string get_host_name() {
+    std::string get_host_name() const {
         return GlobalContext::call_with_env([&](auto &&env) {
             return jni::Make<std::string>(
                     *env,
@@ -66,8 +67,36 @@ public:
         });
     }
 
-    bool is_ipv4() {
-        return strchr(get_host_address().c_str(), ':') != nullptr;
+    std::vector<jni::jbyte> get_address() const {
+        return GlobalContext::call_with_env([&](auto &&env) {
+            return jni::Make<std::vector<jni::jbyte>>(
+                    *env,
+                    utils::AccessorBase<InetAddress>{ self_ }
+                            .get_method<jni::Array<jni::jbyte>()>(
+                                    "getAddress")());
+        });
+    }
+
+    bool is_ipv4() const {
+        return strchr(get_host_address().c_str(), ':') == nullptr;
+    }
+
+    /**
+     * Creates an InetAddress out of raw @p address, without performing any
+     * lookups. @p host is what getHostName() will return.
+     */
+    static InetAddress get_by_address(const std::string &host,
+                                      const std::vector<jni::jbyte> &address) {
+        return GlobalContext::call_with_env([&](auto &&env) {
+            return InetAddress{
+                utils::AccessorBase<InetAddress>::get_static_method<
+                        jni::Object<InetAddress>(jni::String,
+                                                 jni::Array<jni::jbyte>)>(
+                        "getByAddress")(
+                        jni::Make<jni::String>(*env, host),
+                        jni::Make<jni::Array<jni::jbyte>>(*env, address))
+            };
+        });
     }
 
     static std::vector<InetAddress> get_all_by_name(const std::string &host) {
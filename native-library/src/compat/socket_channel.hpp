@@ -18,6 +18,7 @@
 
 #include "../jni_wrapper.hpp"
 
+#include <avsystem/commons/avs_errno.h>
 #include <avsystem/commons/avs_socket.h>
 #include <avsystem/commons/avs_time.h>
 
@@ -28,11 +29,16 @@
 #include "../util_classes/native_utils.hpp"
 #include "../util_classes/selectable_channel.hpp"
 
+#include "./network_interface.hpp"
+#include "./resolver.hpp"
 #include "./socket.hpp"
 #include "./socket_address.hpp"
-#include "./socket_error.hpp"
+#include "./socket_stats.hpp"
 
+#include <algorithm>
 #include <optional>
+#include <string>
+#include <vector>
 
 namespace compat {
 
@@ -54,14 +60,52 @@ struct UdpChannelTag {
 
 template <typename ChannelTag>
 class SocketChannel {
+    // State of the channel as driven by this class. All state transitions are
+    // performed by the compat layer itself, so there is no need to ask Java
+    // about them on every send() or receive().
+    enum class State { FRESH, BOUND, CONNECTED, SHUTDOWN, CLOSED };
+
+    struct Endpoint {
+        std::optional<InetAddress> address;
+        std::string host;
+        int port;
+
+        Endpoint() : address(), host(), port(-1) {}
+    };
+
     jni::Global<jni::Object<ChannelTag>> self_;
     avs_time_duration_t timeout_;
-    bool is_shutdown_;
+    State state_;
+    bool reuse_address_;
+    // Cached when the channel gets bound or connected.
+    Endpoint local_;
+    Endpoint remote_;
+    // Link MTU set through avs_net_socket_configuration_t::forced_mtu.
+    int forced_mtu_;
+    // MTU of the interface used to reach the peer; cached on connect().
+    std::optional<int> path_mtu_;
+    SocketStats &stats_;
+    utils::BufferViewCache send_views_;
+    utils::BufferViewCache receive_views_;
+    // Data accepted by send(), but not yet accepted by the kernel. Only used
+    // for TCP, as UDP datagrams are either sent whole or not at all.
+    std::vector<char> outbound_;
+    size_t outbound_offset_;
 
     auto accessor() {
         return utils::AccessorBase<ChannelTag>{ self_ };
     }
 
+    utils::NativeUtils::ReadyState
+    wait_until_ready(avs_time_duration_t timeout,
+                     const utils::NativeUtils::ReadyState &wait_state) {
+        const avs_time_monotonic_t start = avs_time_monotonic_now();
+        auto result = utils::NativeUtils::wait_until_ready(
+                as_selectable_channel(), timeout, wait_state);
+        stats_.record_wait(start);
+        return result;
+    }
+
     auto socket() {
         return Socket<typename ChannelTag::SocketTag>(
                 accessor()
@@ -70,13 +114,9 @@ class SocketChannel {
                                 "socket")());
     }
 
-    void configure_blocking(bool on) {
-        accessor()
-                .template get_method<jni::Object<utils::SelectableChannel>(
-                        jni::jboolean)>("configureBlocking")(on);
-    }
-
-    auto try_connect(const InetAddress &address, int port) {
+    auto try_connect(const InetAddress &address,
+                     int port,
+                     avs_time_monotonic_t deadline) {
         auto resolved_address = InetSocketAddress::from_resolved(address, port);
         if constexpr (std::is_same<ChannelTag, UdpChannelTag>::value) {
             accessor()
@@ -92,9 +132,12 @@ class SocketChannel {
                         "connect")(resolved_address);
         utils::NativeUtils::ReadyState wait_state{};
         wait_state.connect = true;
-        if (!utils::NativeUtils::wait_until_ready(
-                     as_selectable_channel(), NET_CONNECT_TIMEOUT, wait_state)
-                     .connect) {
+        avs_time_duration_t timeout =
+                avs_time_monotonic_diff(deadline, avs_time_monotonic_now());
+        if (avs_time_duration_less(timeout, AVS_TIME_DURATION_ZERO)) {
+            timeout = AVS_TIME_DURATION_ZERO;
+        }
+        if (!wait_until_ready(timeout, wait_state).connect) {
             return AVS_ETIMEDOUT;
         }
         // NOTE: finishConnect() may throw an exception on Java side.
@@ -115,73 +158,409 @@ class SocketChannel {
         }
     }
 
-    void create() {
-        self_ = GlobalContext::call_with_env([&](auto &&env) {
+    static jni::Local<jni::Object<utils::SelectableChannel>>
+    as_selectable_channel(const jni::Object<ChannelTag> &channel) {
+        return GlobalContext::call_with_env([&](auto &&env) {
+            return jni::Cast<utils::SelectableChannel>(
+                    *env,
+                    jni::Class<utils::SelectableChannel>::Find(*env),
+                    channel);
+        });
+    }
+
+    static void close(const jni::Object<ChannelTag> &channel) {
+        utils::AccessorBase<ChannelTag>{ channel }
+                .template get_method<void()>("close")();
+    }
+
+    jni::Global<jni::Object<ChannelTag>> open() {
+        auto channel = GlobalContext::call_with_env([&](auto &&env) {
             return jni::NewGlobal(
                     *env,
                     utils::AccessorBase<ChannelTag>::template get_static_method<
                             jni::Object<ChannelTag>()>("open")());
         });
-        is_shutdown_ = false;
-        configure_blocking(false);
+        auto accessor = utils::AccessorBase<ChannelTag>{ channel };
+        accessor.template get_method<jni::Object<utils::SelectableChannel>(
+                jni::jboolean)>("configureBlocking")(false);
+        if (reuse_address_) {
+            Socket<typename ChannelTag::SocketTag>(
+                    accessor.template get_method<
+                            jni::Object<typename ChannelTag::SocketTag>()>(
+                            "socket")())
+                    .set_reuse_address(true);
+        }
+        return channel;
+    }
+
+    /**
+     * Connects a TCP channel to the first of @p addresses that accepts the
+     * connection, in the spirit of Happy Eyeballs (RFC 8305): connection
+     * attempts are started one after another, CONNECTION_ATTEMPT_DELAY apart
+     * (or immediately after the previous attempt fails), and are then raced
+     * against each other. This way a single unresponsive address does not
+     * consume the whole time until @p deadline before the next one is tried.
+     *
+     * On success, the winning channel replaces self_.
+     */
+    avs_errno_t race_connect(const std::vector<InetAddress> &addresses,
+                             int port,
+                             avs_time_monotonic_t deadline) {
+        std::vector<jni::Global<jni::Object<ChannelTag>>> attempts;
+        avs_errno_t error = AVS_EHOSTUNREACH;
+        size_t next_address = 0;
+
+        auto close_attempts_except = [&](size_t winner) {
+            for (size_t i = 0; i < attempts.size(); ++i) {
+                if (i != winner) {
+                    close(attempts[i]);
+                }
+            }
+        };
+        auto finish = [&](size_t winner) {
+            close_attempts_except(winner);
+            close();
+            self_ = std::move(attempts[winner]);
+            return AVS_NO_ERROR;
+        };
+
+        utils::NativeUtils::ReadyState wait_state{};
+        wait_state.connect = true;
+        while (avs_time_monotonic_before(avs_time_monotonic_now(), deadline)) {
+            if (next_address < addresses.size()) {
+                attempts.push_back(open());
+                try {
+                    if (utils::AccessorBase<ChannelTag>{ attempts.back() }
+                                .template get_method<jni::jboolean(
+                                        jni::Object<SocketAddress>)>("connect")(
+                                        InetSocketAddress::from_resolved(
+                                                addresses[next_address],
+                                                port))) {
+                        return finish(attempts.size() - 1);
+                    }
+                } catch (jni::PendingJavaException &) {
+                    // e.g. network unreachable for this address family
+                    avs_log_and_clear_exception(DEBUG);
+                    close(attempts.back());
+                    attempts.pop_back();
+                    error = AVS_ENETUNREACH;
+                }
+                ++next_address;
+            }
+            if (attempts.empty()) {
+                if (next_address < addresses.size()) {
+                    continue;
+                }
+                return error;
+            }
+
+            avs_time_duration_t wait_time =
+                    avs_time_monotonic_diff(deadline, avs_time_monotonic_now());
+            if (next_address < addresses.size()
+                    && avs_time_duration_less(CONNECTION_ATTEMPT_DELAY,
+                                              wait_time)) {
+                wait_time = CONNECTION_ATTEMPT_DELAY;
+            }
+            if (avs_time_duration_less(wait_time, AVS_TIME_DURATION_ZERO)) {
+                wait_time = AVS_TIME_DURATION_ZERO;
+            }
+
+            auto channels = GlobalContext::call_with_env([&](auto &&env) {
+                auto result =
+                        jni::Array<jni::Object<utils::SelectableChannel>>::New(
+                                *env, attempts.size());
+                for (size_t i = 0; i < attempts.size(); ++i) {
+                    result.Set(*env, static_cast<jni::jsize>(i),
+                               as_selectable_channel(attempts[i]));
+                }
+                return result;
+            });
+            const avs_time_monotonic_t wait_start = avs_time_monotonic_now();
+            const int ready = utils::NativeUtils::wait_until_any_ready(
+                    channels, wait_time, wait_state);
+            stats_.record_wait(wait_start);
+            if (ready < 0) {
+                continue;
+            }
+            // NOTE: finishConnect() may throw an exception on Java side.
+            try {
+                if (utils::AccessorBase<ChannelTag>{ attempts[ready] }
+                            .template get_method<jni::jboolean()>(
+                                    "finishConnect")()) {
+                    return finish(ready);
+                }
+                // Reported ready, but still pending. Selecting it again would
+                // return immediately, spinning until the deadline, so the
+                // attempt is given up instead.
+                error = AVS_ETIMEDOUT;
+            } catch (jni::PendingJavaException &) {
+                avs_log_and_clear_exception(DEBUG);
+                // Probably connection refused.
+                error = AVS_ECONNREFUSED;
+            }
+            close(attempts[ready]);
+            attempts.erase(attempts.begin() + ready);
+        }
+        close_attempts_except(attempts.size());
+        return AVS_ETIMEDOUT;
+    }
+
+    void create() {
+        self_ = open();
+        state_ = State::FRESH;
+        local_ = Endpoint();
+        remote_ = Endpoint();
+        path_mtu_ = {};
+        outbound_.clear();
+        outbound_offset_ = 0;
+    }
+
+    static Endpoint make_endpoint(std::optional<InetAddress> &&address,
+                                  int port) {
+        Endpoint result;
+        if (address) {
+            result.host = address->get_host_address();
+            result.address = std::move(address);
+        }
+        result.port = port;
+        return result;
+    }
+
+    void update_state(State state) {
+        auto s = socket();
+        local_ = make_endpoint(s.get_local_address(), s.get_local_port());
+        if (state == State::CONNECTED) {
+            remote_ = make_endpoint(s.get_remote_address(),
+                                    s.get_remote_port());
+            if constexpr (std::is_same<ChannelTag, UdpChannelTag>::value) {
+                // Java has no equivalent of IP_MTU, so the MTU of the local
+                // interface is the closest approximation of the path MTU.
+                if (local_.address) {
+                    path_mtu_ = NetworkInterface::get_mtu_by_address(
+                            *local_.address);
+                }
+            }
+        }
+        state_ = state;
+    }
+
+    bool is_connected() const {
+        return state_ == State::CONNECTED;
+    }
+
+    avs_error_t
+    write_nonblocking(const char *data, size_t length, size_t *out_written) {
+        try {
+            // NOTE: Java does not touch the contents of the buffer it
+            // write()s.
+            const int written =
+                    accessor()
+                            .template get_method<jni::jint(
+                                    jni::Object<utils::ByteBuffer>)>("write")(
+                                    send_views_.view(const_cast<char *>(data),
+                                                     length));
+            *out_written = static_cast<size_t>(std::max(0, written));
+            return AVS_OK;
+        } catch (jni::PendingJavaException &) {
+            avs_log_and_clear_exception(DEBUG);
+            return avs_errno(AVS_ECONNABORTED);
+        }
+    }
+
+    /**
+     * Writes as much of the queued outbound data as the kernel accepts without
+     * blocking.
+     */
+    avs_error_t flush_outbound() {
+        while (outbound_offset_ < outbound_.size()) {
+            size_t written;
+            avs_error_t err =
+                    write_nonblocking(outbound_.data() + outbound_offset_,
+                                      outbound_.size() - outbound_offset_,
+                                      &written);
+            if (avs_is_err(err)) {
+                return err;
+            }
+            if (!written) {
+                break;
+            }
+            outbound_offset_ += written;
+        }
+        if (outbound_offset_ == outbound_.size()) {
+            outbound_.clear();
+            outbound_offset_ = 0;
+        } else if (outbound_offset_ > outbound_.size() / 2) {
+            // Release the consumed prefix, so that a peer that never lets the
+            // queue drain completely does not make it grow without bound.
+            outbound_.erase(outbound_.begin(),
+                            outbound_.begin()
+                                    + static_cast<std::ptrdiff_t>(
+                                            outbound_offset_));
+            outbound_offset_ = 0;
+        }
+        return AVS_OK;
+    }
+
+    /**
+     * TCP variant of send(): whatever the kernel does not accept right away is
+     * queued and flushed later - on subsequent send() or receive() calls, or
+     * when the event loop observes that the channel is writable (see flush()).
+     * This way a slow peer does not block the thread shared with all other
+     * connections.
+     *
+     * send() never waits. If more than OUTBOUND_HIGH_WATER_MARK bytes are
+     * still queued, it fails with AVS_ENOBUFS right away without accepting any
+     * of the data, so a stalled peer cannot make the queue grow indefinitely.
+     */
+    avs_error_t queueing_send(const char *data, size_t length) {
+        avs_error_t err = flush_outbound();
+        if (avs_is_err(err)) {
+            return err;
+        }
+        if (pending_output_size() > OUTBOUND_HIGH_WATER_MARK) {
+            ++stats_.send_stalls;
+            return avs_errno(AVS_ENOBUFS);
+        }
+        size_t sent = 0;
+        if (!has_pending_output()
+                && avs_is_err((err = write_nonblocking(data, length, &sent)))) {
+            return err;
+        }
+        if (sent < length) {
+            ++stats_.send_stalls;
+            outbound_.insert(outbound_.end(), data + sent, data + length);
+        }
+        return AVS_OK;
     }
 
     void recreate_if_required() {
-        if (socket().is_closed()) {
+        if (state_ == State::CLOSED) {
             create();
         }
     }
 
     static constexpr avs_time_duration_t NET_CONNECT_TIMEOUT{ 10, 0 };
+    static constexpr avs_time_duration_t CONNECTION_ATTEMPT_DELAY{ 0,
+                                                                  250000000 };
     static constexpr avs_time_duration_t NET_SEND_TIMEOUT{ 30, 0 };
+    static constexpr size_t OUTBOUND_HIGH_WATER_MARK = 64 * 1024;
 
 public:
-    SocketChannel()
+    SocketChannel(SocketStats &stats)
             : self_(),
               timeout_(AVS_NET_SOCKET_DEFAULT_RECV_TIMEOUT),
-              is_shutdown_() {
+              state_(),
+              reuse_address_(),
+              local_(),
+              remote_(),
+              forced_mtu_(),
+              path_mtu_(),
+              stats_(stats),
+              send_views_(),
+              receive_views_(),
+              outbound_(),
+              outbound_offset_() {
         create();
     }
 
     jni::Local<jni::Object<utils::SelectableChannel>>
     as_selectable_channel() const {
-        return GlobalContext::call_with_env([&](auto &&env) {
-            return jni::Cast<utils::SelectableChannel>(
-                    *env,
-                    jni::Class<utils::SelectableChannel>::Find(*env),
-                    self_);
-        });
+        return as_selectable_channel(self_);
     }
 
     void close() {
-        accessor().template get_method<void()>("close")();
+        close(self_);
+        state_ = State::CLOSED;
+        outbound_.clear();
+        outbound_offset_ = 0;
     }
 
-    void connect(const char *host, const char *port) {
+    size_t pending_output_size() const {
+        return outbound_.size() - outbound_offset_;
+    }
+
+    bool has_pending_output() const {
+        return pending_output_size() > 0;
+    }
+
+    /**
+     * Writes as much of the data queued by send() as possible without
+     * blocking. Intended to be called when the channel becomes writable.
+     */
+    avs_error_t flush() {
+        return flush_outbound();
+    }
+
+    avs_error_t connect(const char *host, const char *port) {
         if (!host || !port) {
-            avs_throw(SocketError(AVS_EINVAL, "host & port MUST NOT be NULL"));
+            return avs_errno(AVS_EINVAL);
         }
 
         recreate_if_required();
+        // Name resolution and all connection attempts share a single
+        // NET_CONNECT_TIMEOUT, whether the attempts are raced or not.
+        const avs_time_monotonic_t deadline =
+                avs_time_monotonic_add(avs_time_monotonic_now(),
+                                       NET_CONNECT_TIMEOUT);
+        std::shared_ptr<const Resolver::Addresses> resolved;
+        avs_error_t err = Resolver::instance().resolve(
+                host,
+                avs_time_monotonic_diff(deadline, avs_time_monotonic_now()),
+                &resolved);
+        if (avs_is_err(err)) {
+            return err;
+        }
+        std::vector<InetAddress> addresses;
+        for (const auto &address : *resolved) {
+            addresses.push_back(InetAddress::get_by_address(host, address));
+        }
         avs_errno_t error = AVS_EHOSTUNREACH;
-        for (const InetAddress &addr : InetAddress::get_all_by_name(host)) {
-            if (!(error = try_connect(addr, std::stoi(port)))) {
-                return;
+        if constexpr (std::is_same<ChannelTag, TcpChannelTag>::value) {
+            // Racing requires fresh channels, which would lose the local
+            // address the current one might have been bound to. Such
+            // channels try the addresses one by one instead.
+            if (addresses.size() > 1 && state_ == State::FRESH) {
+                if ((error = race_connect(addresses, std::stoi(port),
+                                          deadline))) {
+                    close();
+                    return avs_errno(error);
+                }
+                update_state(State::CONNECTED);
+                return AVS_OK;
             }
         }
-        avs_throw(SocketError(error, "could not connect()"));
+        for (const InetAddress &addr : addresses) {
+            if (!(error = try_connect(addr, std::stoi(port), deadline))) {
+                update_state(State::CONNECTED);
+                return AVS_OK;
+            }
+            if (!avs_time_monotonic_before(avs_time_monotonic_now(),
+                                           deadline)) {
+                error = AVS_ETIMEDOUT;
+                break;
+            }
+        }
+        if constexpr (std::is_same<ChannelTag, TcpChannelTag>::value) {
+            // Java closes the channel on failed finishConnect() anyway, and a
+            // timed out one would still have the connection pending.
+            close();
+        }
+        return avs_errno(error);
     }
 
-    void send(const void *buffer, size_t buffer_length) {
-        if (!socket().is_connected()) {
-            avs_throw(SocketError(AVS_ENOTCONN,
-                                  "Cannot send() on unconnected socket"));
+    avs_error_t send(const void *buffer, size_t buffer_length) {
+        if (!is_connected()) {
+            return avs_errno(AVS_ENOTCONN);
+        }
+        if constexpr (std::is_same<ChannelTag, TcpChannelTag>::value) {
+            return queueing_send(static_cast<const char *>(buffer),
+                                 buffer_length);
         }
         const avs_time_monotonic_t deadline =
                 avs_time_monotonic_add(avs_time_monotonic_now(),
                                        NET_SEND_TIMEOUT);
-        utils::BufferView byte_buffer{ const_cast<void *>(buffer),
-                                       buffer_length };
+        // NOTE: Java does not touch the contents of the buffer it write()s.
+        char *data = const_cast<char *>(static_cast<const char *>(buffer));
         size_t sent_so_far = 0;
 
         auto try_send_next_chunk = [&]() {
@@ -193,13 +572,12 @@ public:
             if (avs_time_duration_less(timeout, AVS_TIME_DURATION_ZERO)) {
                 timeout = AVS_TIME_DURATION_ZERO;
             }
-            if (utils::NativeUtils::wait_until_ready(
-                        as_selectable_channel(), timeout, wait_state)
-                        .write) {
+            if (wait_until_ready(timeout, wait_state).write) {
                 return accessor()
                         .template get_method<jni::jint(
                                 jni::Object<utils::ByteBuffer>)>("write")(
-                                byte_buffer.into_java());
+                                send_views_.view(data + sent_so_far,
+                                                 buffer_length - sent_so_far));
             }
             return 0;
         };
@@ -212,11 +590,12 @@ public:
                 // handled and did not yet occurr, then the underlying problem
                 // must be serious.
                 avs_log_and_clear_exception(DEBUG);
-                avs_throw(SocketError(AVS_ECONNABORTED));
+                return avs_errno(AVS_ECONNABORTED);
             }
             if constexpr (std::is_same<ChannelTag, UdpChannelTag>::value) {
                 if (sent_so_far < buffer_length) {
-                    avs_throw(SocketError(AVS_EIO, "send() fail"));
+                    ++stats_.send_stalls;
+                    return avs_errno(AVS_EIO);
                 }
             }
         } while (sent_so_far < buffer_length
@@ -224,38 +603,43 @@ public:
                                               deadline));
 
         if (sent_so_far < buffer_length) {
-            avs_throw(SocketError(AVS_ETIMEDOUT, "timeout while send()"));
+            return avs_errno(AVS_ETIMEDOUT);
         }
+        return AVS_OK;
     }
 
-    void timeout_respecting_receive(size_t *out_size,
-                                    void *buffer,
-                                    size_t buffer_length) {
-        if (!socket().is_connected()) {
-            avs_throw(SocketError(AVS_ENOTCONN,
-                                  "Cannot receive() from unconnected socket"));
+    avs_error_t timeout_respecting_receive(size_t *out_size,
+                                           void *buffer,
+                                           size_t buffer_length) {
+        if (!is_connected()) {
+            return avs_errno(AVS_ENOTCONN);
+        }
+        avs_error_t err = flush_outbound();
+        if (avs_is_err(err)) {
+            return err;
         }
         utils::NativeUtils::ReadyState wait_state{};
         wait_state.read = true;
 
-        if (!utils::NativeUtils::wait_until_ready(
-                     as_selectable_channel(), timeout_, wait_state)
-                     .read) {
-            avs_throw(SocketError(AVS_ETIMEDOUT));
+        // NOTE: This is the expected outcome of every anjay_serve() call,
+        // which reads until there is no more data.
+        if (!wait_until_ready(timeout_, wait_state).read) {
+            return avs_errno(AVS_ETIMEDOUT);
         }
-        utils::BufferView byte_buffer{ buffer, buffer_length };
         try {
             int read = accessor()
                                .template get_method<jni::jint(
                                        jni::Object<utils::ByteBuffer>)>("read")(
-                                       byte_buffer.into_java());
+                                       receive_views_.view(buffer,
+                                                           buffer_length));
             // -1 is EOF
             *out_size = std::max(0, read);
         } catch (jni::PendingJavaException &) {
             // Probably the connection is lost.
             avs_log_and_clear_exception(DEBUG);
-            avs_throw(SocketError(AVS_ECONNREFUSED));
+            return avs_errno(AVS_ECONNREFUSED);
         }
+        return AVS_OK;
     }
 
     void bind(const char *localaddr, const char *port) {
@@ -272,15 +656,15 @@ public:
                             jni::Object<SocketAddress>)>("bind")(
                             InetSocketAddress::from_port(port));
         }
+        update_state(State::BOUND);
     }
 
-    void set_timeout(avs_time_duration_t duration) {
-        if (!avs_time_duration_valid(timeout_)) {
-            avs_throw(SocketError(
-                    AVS_EINVAL,
-                    "Timeout cannot be set to an invalid duration"));
+    avs_error_t set_timeout(avs_time_duration_t duration) {
+        if (!avs_time_duration_valid(duration)) {
+            return avs_errno(AVS_EINVAL);
         }
         timeout_ = duration;
+        return AVS_OK;
     }
 
     avs_time_duration_t get_timeout() {
@@ -288,65 +672,83 @@ public:
     }
 
     void set_reuse_address(bool on) {
+        reuse_address_ = on;
         return socket().set_reuse_address(on);
     }
 
-    avs_net_socket_state_t get_state() {
-        auto s = socket();
-        if (s.is_closed()) {
-            return AVS_NET_SOCKET_STATE_CLOSED;
-        }
-        if (is_shutdown_) {
-            return AVS_NET_SOCKET_STATE_SHUTDOWN;
-        }
-        if (s.is_connected()) {
-            return AVS_NET_SOCKET_STATE_CONNECTED;
-        }
-        if (s.is_bound()) {
+    bool is_closed() const {
+        return state_ == State::CLOSED;
+    }
+
+    avs_net_socket_state_t get_state() const {
+        switch (state_) {
+        case State::BOUND:
             return AVS_NET_SOCKET_STATE_BOUND;
+        case State::CONNECTED:
+            return AVS_NET_SOCKET_STATE_CONNECTED;
+        case State::SHUTDOWN:
+            return AVS_NET_SOCKET_STATE_SHUTDOWN;
+        default:
+            // Both closed sockets and the ones in initial state.
+            return AVS_NET_SOCKET_STATE_CLOSED;
         }
-        // The socket is not closed, not shutdown, not connected, and not bound,
-        // which means it is in initial state.
-        return AVS_NET_SOCKET_STATE_CLOSED;
     }
 
-    std::optional<InetAddress> get_remote_address() {
-        return socket().get_remote_address();
+    const std::optional<InetAddress> &get_remote_address() const {
+        return remote_.address;
+    }
+
+    const std::string &get_remote_host() const {
+        return remote_.host;
     }
 
-    std::optional<InetAddress> get_local_address() {
-        return socket().get_local_address();
+    const std::string &get_local_host() const {
+        return local_.host;
     }
 
-    int get_local_port() {
-        return socket().get_local_port();
+    int get_local_port() const {
+        return local_.port;
     }
 
-    int get_remote_port() {
-        return socket().get_remote_port();
+    int get_remote_port() const {
+        return remote_.port;
     }
 
-    int get_inner_mtu() {
+    avs_error_t get_inner_mtu(int *out_mtu) {
         if constexpr (std::is_same<ChannelTag, TcpChannelTag>::value) {
-            avs_throw(SocketError(
-                    AVS_ENOTSUP,
-                    "Getting inner MTU for TCP sockets is not supported"));
+            // Getting inner MTU for TCP sockets is not supported
+            return avs_errno(AVS_ENOTSUP);
         }
 
-        auto remote = get_remote_address();
+        const auto &remote = get_remote_address();
         if (!remote) {
-            avs_throw(SocketError(AVS_EIO, "could not get remote address"));
+            return avs_errno(AVS_EIO);
+        }
+        int mtu = forced_mtu_;
+        if (mtu <= 0 && path_mtu_) {
+            mtu = *path_mtu_;
         }
         if (remote->is_ipv4()) {
-            return 548; /* 576 - (20 for IP + 8 for UDP) */
+            if (mtu <= 0) {
+                mtu = 576; /* minimum IPv4 MTU */
+            }
+            *out_mtu = mtu - 28; /* 20 for IP + 8 for UDP */
         } else {
-            return 1232; /* 1280 - (40 for IPv6 + 8 for UDP) */
+            if (mtu <= 0) {
+                mtu = 1280; /* minimum IPv6 MTU */
+            }
+            *out_mtu = mtu - 48; /* 40 for IPv6 + 8 for UDP */
         }
+        return AVS_OK;
+    }
+
+    void set_forced_mtu(int mtu) {
+        forced_mtu_ = mtu;
     }
 
     void shutdown() {
         if constexpr (std::is_same<ChannelTag, TcpChannelTag>::value) {
-            is_shutdown_ = true;
+            state_ = State::SHUTDOWN;
             accessor().template get_method<jni::Object<ChannelTag>()>(
                     "shutdownInput")();
             accessor().template get_method<jni::Object<ChannelTag>()>(
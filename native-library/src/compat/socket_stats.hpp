@@ -0,0 +1,87 @@
+/*
+ * Copyright 2020-2024 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <avsystem/commons/avs_errno.h>
+#include <avsystem/commons/avs_time.h>
+
+#include <cstdint>
+#include <map>
+
+namespace compat {
+
+/**
+ * Round-trip time estimate of confirmable CoAP exchanges, as per RFC 6298.
+ * Durations are invalid until the first sample is taken.
+ */
+struct RttEstimate {
+    uint64_t samples;
+    avs_time_duration_t smoothed_rtt;
+    avs_time_duration_t rtt_variation;
+    avs_time_duration_t retransmission_timeout;
+
+    RttEstimate()
+            : samples(),
+              smoothed_rtt(AVS_TIME_DURATION_INVALID),
+              rtt_variation(AVS_TIME_DURATION_INVALID),
+              retransmission_timeout(AVS_TIME_DURATION_INVALID) {}
+};
+
+/**
+ * Traffic counters of a single socket. They are only updated natively and read
+ * on demand, so keeping them costs no JNI calls.
+ */
+struct SocketStats {
+    uint64_t bytes_sent;
+    uint64_t bytes_received;
+    uint64_t send_calls;
+    uint64_t receive_calls;
+    uint64_t receive_timeouts;
+    // Number of times the kernel did not accept all of the data at once.
+    uint64_t send_stalls;
+    // Total time spent waiting for the channel to become ready.
+    avs_time_duration_t wait_time;
+    std::map<avs_errno_t, uint64_t> errors;
+    // Only measured if adaptive tx params are enabled; see rtt_estimator.hpp.
+    RttEstimate rtt;
+
+    SocketStats()
+            : bytes_sent(),
+              bytes_received(),
+              send_calls(),
+              receive_calls(),
+              receive_timeouts(),
+              send_stalls(),
+              wait_time(AVS_TIME_DURATION_ZERO),
+              errors(),
+              rtt() {}
+
+    avs_error_t record_error(avs_error_t err) {
+        if (avs_is_err(err) && err.category == AVS_ERRNO_CATEGORY) {
+            ++errors[static_cast<avs_errno_t>(err.code)];
+        }
+        return err;
+    }
+
+    void record_wait(avs_time_monotonic_t since) {
+        wait_time = avs_time_duration_add(
+                wait_time,
+                avs_time_monotonic_diff(avs_time_monotonic_now(), since));
+    }
+};
+
+} // namespace compat
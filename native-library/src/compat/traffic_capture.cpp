@@ -0,0 +1,325 @@
+/*
+ * Copyright 2020-2024 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "./traffic_capture.hpp"
+
+#include <avsystem/commons/avs_log.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+#include "../util_classes/exception.hpp"
+
+#define LOG(...) avs_log(traffic_capture, __VA_ARGS__)
+
+namespace compat {
+
+namespace {
+
+const char MAGIC[] = "AJNICAP";
+const uint8_t VERSION = 1;
+
+template <typename T>
+void append_le(std::vector<char> &out, T value) {
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+}
+
+template <typename T>
+T read_le(const char *data) {
+    T result = 0;
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        result |= static_cast<T>(static_cast<uint8_t>(data[i])) << (8 * i);
+    }
+    return result;
+}
+
+const size_t RECORD_HEADER_SIZE = 1 + 4 + 8 + 4 + 4;
+
+const size_t COAP_UDP_HEADER_SIZE = 4;
+const uint8_t COAP_TYPE_ACK = 2;
+const uint8_t COAP_TYPE_RST = 3;
+
+struct CoapUdpHeader {
+    uint8_t type;
+    uint16_t message_id;
+    std::vector<char> token;
+};
+
+bool parse_coap_udp(const char *data, size_t length, CoapUdpHeader *out) {
+    if (length < COAP_UDP_HEADER_SIZE
+            || (static_cast<uint8_t>(data[0]) >> 6) != 1) {
+        return false;
+    }
+    const size_t token_length = static_cast<uint8_t>(data[0]) & 0x0F;
+    if (token_length > 8 || length < COAP_UDP_HEADER_SIZE + token_length) {
+        return false;
+    }
+    out->type = (static_cast<uint8_t>(data[0]) >> 4) & 0x03;
+    out->message_id = static_cast<uint16_t>(
+            (static_cast<uint8_t>(data[2]) << 8)
+            | static_cast<uint8_t>(data[3]));
+    out->token.assign(data + COAP_UDP_HEADER_SIZE,
+                      data + COAP_UDP_HEADER_SIZE + token_length);
+    return true;
+}
+
+template <typename K, typename V>
+void remember(std::map<K, V> &mapping,
+              std::deque<K> &order,
+              size_t limit,
+              const K &key,
+              const V &value) {
+    if (mapping.find(key) == mapping.end()) {
+        order.push_back(key);
+        if (order.size() > limit) {
+            mapping.erase(order.front());
+            order.pop_front();
+        }
+    }
+    mapping[key] = value;
+}
+
+} // namespace
+
+const std::shared_ptr<CaptureWriter> &CaptureWriter::instance() {
+    static const std::shared_ptr<CaptureWriter> writer =
+            []() -> std::shared_ptr<CaptureWriter> {
+        const char *path = getenv(ENV_VARIABLE);
+        if (!path || !*path) {
+            return nullptr;
+        }
+        LOG(INFO, "recording traffic to %s", path);
+        return std::make_shared<CaptureWriter>(path);
+    }();
+    return writer;
+}
+
+CaptureWriter::CaptureWriter(const std::string &path)
+        : mutex_(),
+          file_(fopen(path.c_str(), "wb")),
+          start_(avs_time_monotonic_now()),
+          last_flush_(start_),
+          next_socket_() {
+    if (!file_) {
+        avs_throw(std::runtime_error("could not open capture file " + path));
+    }
+    fwrite(MAGIC, 1, sizeof(MAGIC), file_);
+    fwrite(&VERSION, 1, 1, file_);
+    fflush(file_);
+}
+
+CaptureWriter::~CaptureWriter() {
+    fclose(file_);
+}
+
+uint32_t CaptureWriter::open_socket(bool tcp) {
+    uint32_t socket;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        socket = next_socket_++;
+    }
+    write(tcp ? CaptureRecordType::OPEN_TCP : CaptureRecordType::OPEN_UDP,
+          socket, static_cast<avs_errno_t>(0), nullptr, 0);
+    return socket;
+}
+
+void CaptureWriter::write(CaptureRecordType type,
+                          uint32_t socket,
+                          avs_errno_t status,
+                          const void *data,
+                          size_t length) {
+    int64_t timestamp_ns = 0;
+    avs_time_duration_to_scalar(
+            &timestamp_ns, AVS_TIME_NS,
+            avs_time_monotonic_diff(avs_time_monotonic_now(), start_));
+
+    std::vector<char> record;
+    record.reserve(RECORD_HEADER_SIZE + length);
+    append_le(record, static_cast<uint8_t>(type));
+    append_le(record, socket);
+    append_le(record, static_cast<uint64_t>(timestamp_ns));
+    append_le(record, static_cast<uint32_t>(status));
+    append_le(record, static_cast<uint32_t>(length));
+    if (length) {
+        record.insert(record.end(), static_cast<const char *>(data),
+                      static_cast<const char *>(data) + length);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (fwrite(record.data(), 1, record.size(), file_) != record.size()) {
+        LOG(WARNING, "could not write capture record");
+        return;
+    }
+    const avs_time_monotonic_t now = avs_time_monotonic_now();
+    if (!avs_time_monotonic_before(
+                now, avs_time_monotonic_add(last_flush_, FLUSH_INTERVAL))) {
+        last_flush_ = now;
+        if (fflush(file_)) {
+            LOG(WARNING, "could not flush capture file");
+        }
+    }
+}
+
+const std::shared_ptr<CaptureReader> &CaptureReader::instance() {
+    static const std::shared_ptr<CaptureReader> reader =
+            []() -> std::shared_ptr<CaptureReader> {
+        const char *path = getenv(ENV_VARIABLE);
+        if (!path || !*path) {
+            return nullptr;
+        }
+        LOG(INFO, "replaying traffic from %s", path);
+        return std::make_shared<CaptureReader>(path);
+    }();
+    return reader;
+}
+
+CaptureReader::CaptureReader(const std::string &path)
+        : mutex_(), tcp_sockets_(), receives_(), sends_(), next_socket_() {
+    std::unique_ptr<FILE, decltype(&fclose)> file(fopen(path.c_str(), "rb"),
+                                                  fclose);
+    if (!file) {
+        avs_throw(std::runtime_error("could not open capture file " + path));
+    }
+    std::vector<char> contents;
+    char chunk[4096];
+    size_t read;
+    while ((read = fread(chunk, 1, sizeof(chunk), file.get())) > 0) {
+        contents.insert(contents.end(), chunk, chunk + read);
+    }
+
+    if (contents.size() < sizeof(MAGIC) + 1
+            || memcmp(contents.data(), MAGIC, sizeof(MAGIC))
+            || static_cast<uint8_t>(contents[sizeof(MAGIC)]) != VERSION) {
+        avs_throw(std::runtime_error("invalid capture file " + path));
+    }
+
+    size_t offset = sizeof(MAGIC) + 1;
+    while (offset + RECORD_HEADER_SIZE <= contents.size()) {
+        const char *header = contents.data() + offset;
+        const auto type = static_cast<CaptureRecordType>(header[0]);
+        const uint32_t socket = read_le<uint32_t>(header + 1);
+        const uint32_t status = read_le<uint32_t>(header + 13);
+        const uint32_t length = read_le<uint32_t>(header + 17);
+        offset += RECORD_HEADER_SIZE;
+        if (offset + length > contents.size()) {
+            LOG(WARNING, "truncated capture record, ignoring the rest");
+            break;
+        }
+        if (type == CaptureRecordType::OPEN_TCP) {
+            tcp_sockets_.insert(socket);
+        } else if (type == CaptureRecordType::SEND && !status) {
+            sends_[socket].emplace_back(contents.data() + offset,
+                                        contents.data() + offset + length);
+        } else if (type == CaptureRecordType::RECEIVE) {
+            receives_[socket].push_back(
+                    Receive{ static_cast<avs_errno_t>(status),
+                             std::vector<char>(contents.data() + offset,
+                                               contents.data() + offset
+                                                       + length) });
+        }
+        offset += length;
+    }
+}
+
+uint32_t CaptureReader::open_socket() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return next_socket_++;
+}
+
+bool CaptureReader::is_tcp(uint32_t socket) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return tcp_sockets_.count(socket) > 0;
+}
+
+bool CaptureReader::has_receive(uint32_t socket) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = receives_.find(socket);
+    return it != receives_.end() && !it->second.empty();
+}
+
+bool CaptureReader::next_receive(uint32_t socket, Receive *out) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = receives_.find(socket);
+    if (it == receives_.end() || it->second.empty()) {
+        return false;
+    }
+    *out = std::move(it->second.front());
+    it->second.pop_front();
+    return true;
+}
+
+bool CaptureReader::next_send(uint32_t socket, std::vector<char> *out) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = sends_.find(socket);
+    if (it == sends_.end() || it->second.empty()) {
+        return false;
+    }
+    *out = std::move(it->second.front());
+    it->second.pop_front();
+    return true;
+}
+
+CoapExchangeMapper::CoapExchangeMapper()
+        : tokens_(), token_order_(), message_ids_(), message_id_order_() {}
+
+void CoapExchangeMapper::on_send(const std::vector<char> &recorded,
+                                 const void *actual,
+                                 size_t actual_length) {
+    CoapUdpHeader recorded_header;
+    CoapUdpHeader actual_header;
+    if (!parse_coap_udp(recorded.data(), recorded.size(), &recorded_header)
+            || !parse_coap_udp(static_cast<const char *>(actual),
+                               actual_length, &actual_header)) {
+        return;
+    }
+    remember(message_ids_, message_id_order_, MAX_MAPPINGS,
+             recorded_header.message_id, actual_header.message_id);
+    if (!recorded_header.token.empty()) {
+        remember(tokens_, token_order_, MAX_MAPPINGS, recorded_header.token,
+                 actual_header.token);
+    }
+}
+
+void CoapExchangeMapper::rewrite(std::vector<char> &datagram) const {
+    CoapUdpHeader header;
+    if (!parse_coap_udp(datagram.data(), datagram.size(), &header)) {
+        return;
+    }
+    // Only ACK and RST messages carry the message ID of the client's message;
+    // CON and NON ones are numbered by the server itself.
+    if (header.type == COAP_TYPE_ACK || header.type == COAP_TYPE_RST) {
+        auto message_id = message_ids_.find(header.message_id);
+        if (message_id != message_ids_.end()) {
+            datagram[2] = static_cast<char>(message_id->second >> 8);
+            datagram[3] = static_cast<char>(message_id->second & 0xFF);
+        }
+    }
+    auto token = tokens_.find(header.token);
+    if (token != tokens_.end() && token->second != header.token) {
+        const auto token_begin = datagram.begin() + COAP_UDP_HEADER_SIZE;
+        datagram.erase(token_begin, token_begin + header.token.size());
+        datagram.insert(datagram.begin() + COAP_UDP_HEADER_SIZE,
+                        token->second.begin(), token->second.end());
+        datagram[0] = static_cast<char>(
+                (static_cast<uint8_t>(datagram[0]) & 0xF0)
+                | static_cast<uint8_t>(token->second.size()));
+    }
+}
+
+} // namespace compat
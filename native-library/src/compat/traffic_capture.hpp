@@ -0,0 +1,181 @@
+/*
+ * Copyright 2020-2024 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <avsystem/commons/avs_errno.h>
+#include <avsystem/commons/avs_time.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace compat {
+
+/**
+ * Recording and replaying of the traffic passing through the compat socket
+ * layer, meant for reproducible benchmarks without a real LwM2M server.
+ *
+ * Recording is enabled by setting the ANJAY_JNI_RECORD_TRAFFIC environment
+ * variable to a path of the capture file to create. Setting
+ * ANJAY_JNI_REPLAY_TRAFFIC to a path of such file makes all sockets created
+ * afterwards replay the received data from it at full speed, without any
+ * network access (see ReplaySocket).
+ *
+ * Capture file format (all integers are little-endian):
+ *
+ *   header: "AJNICAP\0" version:u8
+ *   record: type:u8 socket:u32 timestamp_ns:u64 status:u32 length:u32
+ *           data[length]
+ *
+ * Sockets are numbered in the order of creation. Timestamps are relative to
+ * the moment recording started. status is zero, or an avs_errno_t value if the
+ * operation failed (e.g. AVS_ETIMEDOUT for receives that got no data).
+ *
+ * Records are buffered and flushed to the file at most once per
+ * FLUSH_INTERVAL, so that recording does not add a syscall to every packet.
+ */
+enum class CaptureRecordType : uint8_t {
+    OPEN_UDP = 0,
+    OPEN_TCP = 1,
+    CONNECT = 2,
+    SEND = 3,
+    RECEIVE = 4,
+    CLOSE = 5
+};
+
+class CaptureWriter {
+    CaptureWriter(const CaptureWriter &) = delete;
+    CaptureWriter &operator=(const CaptureWriter &) = delete;
+
+    static constexpr avs_time_duration_t FLUSH_INTERVAL{ 1, 0 };
+
+    std::mutex mutex_;
+    FILE *file_;
+    avs_time_monotonic_t start_;
+    avs_time_monotonic_t last_flush_;
+    uint32_t next_socket_;
+
+public:
+    static constexpr const char *ENV_VARIABLE = "ANJAY_JNI_RECORD_TRAFFIC";
+
+    /**
+     * Returns the capture writer if recording is enabled, or nullptr
+     * otherwise.
+     */
+    static const std::shared_ptr<CaptureWriter> &instance();
+
+    explicit CaptureWriter(const std::string &path);
+    ~CaptureWriter();
+
+    /**
+     * Writes an OPEN_* record and returns the identifier of the new socket.
+     */
+    uint32_t open_socket(bool tcp);
+
+    void write(CaptureRecordType type,
+               uint32_t socket,
+               avs_errno_t status,
+               const void *data,
+               size_t length);
+};
+
+class CaptureReader {
+    CaptureReader(const CaptureReader &) = delete;
+    CaptureReader &operator=(const CaptureReader &) = delete;
+
+public:
+    struct Receive {
+        avs_errno_t status;
+        std::vector<char> data;
+    };
+
+    static constexpr const char *ENV_VARIABLE = "ANJAY_JNI_REPLAY_TRAFFIC";
+
+    /**
+     * Returns the capture reader if replaying is enabled, or nullptr
+     * otherwise.
+     */
+    static const std::shared_ptr<CaptureReader> &instance();
+
+    explicit CaptureReader(const std::string &path);
+
+    /**
+     * Returns identifier of the next socket, in the same order in which they
+     * were numbered when recording.
+     */
+    uint32_t open_socket();
+
+    bool is_tcp(uint32_t socket);
+
+    bool has_receive(uint32_t socket);
+
+    /**
+     * Pops the next recorded receive result for @p socket into @p out.
+     * Returns false if there are no more.
+     */
+    bool next_receive(uint32_t socket, Receive *out);
+
+    /**
+     * Pops the next recorded successfully sent data for @p socket into
+     * @p out. Returns false if there is no more.
+     */
+    bool next_send(uint32_t socket, std::vector<char> *out);
+
+private:
+    std::mutex mutex_;
+    std::set<uint32_t> tcp_sockets_;
+    std::map<uint32_t, std::deque<Receive>> receives_;
+    std::map<uint32_t, std::deque<std::vector<char>>> sends_;
+    uint32_t next_socket_;
+};
+
+/**
+ * Makes replayed CoAP/UDP responses match the requests the client actually
+ * sent. Anjay generates random tokens and message IDs, so they differ between
+ * the recording and the replay.
+ *
+ * Each datagram sent during replay is paired with the one sent at the same
+ * point during recording, which yields the recorded-to-actual mapping of
+ * tokens and message IDs. Recorded datagrams received afterwards are then
+ * rewritten using that mapping.
+ */
+class CoapExchangeMapper {
+    // Exchanges are short-lived, so only the most recent ones are remembered.
+    static constexpr size_t MAX_MAPPINGS = 64;
+
+    std::map<std::vector<char>, std::vector<char>> tokens_;
+    std::deque<std::vector<char>> token_order_;
+    std::map<uint16_t, uint16_t> message_ids_;
+    std::deque<uint16_t> message_id_order_;
+
+public:
+    CoapExchangeMapper();
+
+    void on_send(const std::vector<char> &recorded,
+                 const void *actual,
+                 size_t actual_length);
+
+    void rewrite(std::vector<char> &datagram) const;
+};
+
+} // namespace compat
@@ -57,4 +57,13 @@ public:
         auto &instance = GlobalContext::instance();
         return functor(std::move(jni::GetAttachedEnv(*instance.vm_)));
     }
+
+    /**
+     * Attaches the calling thread to the JVM as a daemon thread, so that it
+     * does not keep the JVM from exiting. The thread is detached when the
+     * returned object is destroyed.
+     */
+    static jni::UniqueEnv attach_daemon_thread() {
+        return jni::AttachCurrentThreadAsDaemon(*GlobalContext::instance().vm_);
+    }
 };
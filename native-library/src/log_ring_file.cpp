@@ -0,0 +1,141 @@
+/*
+ * Copyright 2020-2024 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "./log_ring_file.hpp"
+
+#include "./util_classes/exception.hpp"
+
+#include <avsystem/commons/avs_time.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <new>
+
+LogRingFile::LogRingFile(const std::string &path, size_t size)
+        : mapping_size_(std::max(size, MIN_SIZE)),
+          mapping_(MAP_FAILED),
+          header_(),
+          data_() {
+    // The file is prepared under a temporary name and then renamed, so that
+    // a ring still mapped from the same path keeps its own, intact file.
+    const std::string tmp_path = path + ".tmp";
+    int fd = open(tmp_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        avs_throw(AnjayException(errno, "could not open log ring file"));
+    }
+    if (ftruncate(fd, static_cast<off_t>(mapping_size_))) {
+        int err = errno;
+        close(fd);
+        unlink(tmp_path.c_str());
+        avs_throw(AnjayException(err, "could not resize log ring file"));
+    }
+    mapping_ = mmap(nullptr, mapping_size_, PROT_READ | PROT_WRITE, MAP_SHARED,
+                    fd, 0);
+    int err = errno;
+    // The mapping stays valid after the descriptor is closed.
+    close(fd);
+    if (mapping_ == MAP_FAILED) {
+        unlink(tmp_path.c_str());
+        avs_throw(AnjayException(err, "could not map log ring file"));
+    }
+    header_ = new (mapping_) Header{};
+    memcpy(header_->magic, MAGIC, sizeof(MAGIC));
+    header_->capacity = mapping_size_ - sizeof(Header);
+    data_ = static_cast<char *>(mapping_) + sizeof(Header);
+    if (rename(tmp_path.c_str(), path.c_str())) {
+        err = errno;
+        munmap(mapping_, mapping_size_);
+        unlink(tmp_path.c_str());
+        avs_throw(AnjayException(err, "could not create log ring file"));
+    }
+}
+
+LogRingFile::~LogRingFile() {
+    msync(mapping_, mapping_size_, MS_ASYNC);
+    munmap(mapping_, mapping_size_);
+}
+
+void LogRingFile::write(const char *data, size_t size) {
+    const uint64_t capacity = header_->capacity;
+    uint64_t position = header_->reserved.load(std::memory_order_relaxed);
+    header_->reserved.store(position + size, std::memory_order_relaxed);
+    // Readers must see the reservation before any of the bytes it covers.
+    std::atomic_thread_fence(std::memory_order_release);
+    while (size) {
+        size_t offset = static_cast<size_t>(position % capacity);
+        size_t chunk = std::min<size_t>(size, capacity - offset);
+        memcpy(data_ + offset, data, chunk);
+        data += chunk;
+        size -= chunk;
+        position += chunk;
+    }
+    header_->committed.store(position, std::memory_order_release);
+}
+
+void LogRingFile::append(const char *message) {
+    avs_time_real_t now = avs_time_real_now();
+    char timestamp[32];
+    int length =
+            snprintf(timestamp, sizeof(timestamp), "%" PRId64 ".%06" PRId32 " ",
+                     now.since_real_epoch.seconds,
+                     now.since_real_epoch.nanoseconds / 1000);
+    // Keep single lines small enough not to overwrite themselves.
+    size_t message_length =
+            std::min<size_t>(strlen(message), header_->capacity / 2);
+    if (length > 0) {
+        write(timestamp, static_cast<size_t>(length));
+    }
+    write(message, message_length);
+    write("\n", 1);
+}
+
+std::vector<char> LogRingFile::snapshot() const {
+    const uint64_t capacity = header_->capacity;
+    uint64_t end = header_->committed.load(std::memory_order_acquire);
+    uint64_t begin = end > capacity ? end - capacity : 0;
+
+    std::vector<char> result(static_cast<size_t>(end - begin));
+    for (uint64_t position = begin; position < end;) {
+        size_t offset = static_cast<size_t>(position % capacity);
+        size_t chunk = std::min<size_t>(end - position, capacity - offset);
+        memcpy(result.data() + (position - begin), data_ + offset, chunk);
+        position += chunk;
+    }
+
+    // Whatever the writer may have started to overwrite in the meantime is
+    // unreliable, and the oldest line is likely cut anyway.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint64_t reserved = header_->reserved.load(std::memory_order_relaxed);
+    size_t skip = 0;
+    if (reserved > capacity && reserved - capacity > begin) {
+        skip = static_cast<size_t>(
+                std::min<uint64_t>(reserved - capacity - begin, result.size()));
+    }
+    if (begin > 0 || skip > 0) {
+        auto newline = std::find(result.begin() + skip, result.end(), '\n');
+        skip = newline == result.end() ? result.size()
+                                       : newline - result.begin() + 1;
+    }
+    result.erase(result.begin(), result.begin() + skip);
+    return result;
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright 2020-2024 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <avsystem/commons/avs_log.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * avs_log backend that writes plain text log lines into a fixed-size file
+ * mapped into memory, overwriting the oldest ones when full. Nothing crosses
+ * JNI and no system calls are made per message, so even TRACE output can be
+ * captured without slowing the client down, and the file survives a crash of
+ * the process.
+ *
+ * The file starts with a Header, followed by the circular data area. Byte
+ * number N ever written lives at offset N % capacity of the data area; the
+ * newest one is the one before committed.
+ */
+class LogRingFile {
+    struct Header {
+        char magic[8];
+        uint64_t capacity;
+        // Number of bytes the writer has started writing.
+        std::atomic<uint64_t> reserved;
+        // Number of bytes completely written.
+        std::atomic<uint64_t> committed;
+    };
+
+    const size_t mapping_size_;
+    void *mapping_;
+    Header *header_;
+    char *data_;
+
+    void write(const char *data, size_t size);
+
+    LogRingFile(const LogRingFile &) = delete;
+    LogRingFile &operator=(const LogRingFile &) = delete;
+
+public:
+    static constexpr char MAGIC[8] = { 'A', 'V', 'S', 'L', 'O', 'G', 'R', '1' };
+    static constexpr size_t MIN_SIZE = 4096;
+
+    /**
+     * Creates, or replaces, the file at @p path and maps it into memory.
+     * @p size is the size of the whole file, including the header. Throws if
+     * the file cannot be created, leaving any existing file untouched.
+     */
+    LogRingFile(const std::string &path, size_t size);
+
+    ~LogRingFile();
+
+    /**
+     * Appends a line with a timestamp and @p message. Shall not be called
+     * from more than one thread at a time.
+     */
+    void append(const char *message);
+
+    /**
+     * Returns complete lines currently stored in the ring, oldest first. May
+     * be called concurrently with append().
+     */
+    std::vector<char> snapshot() const;
+};
@@ -19,6 +19,7 @@
 #include "./native_access_control.hpp"
 #include "./native_anjay.hpp"
 #include "./native_anjay_download.hpp"
+#include "./native_anjay_send.hpp"
 #include "./native_attr_storage.hpp"
 #include "./native_bytes_context.hpp"
 #include "./native_firmware_update.hpp"
@@ -48,6 +49,7 @@ extern "C" JNIEXPORT jint JNICALL JNI_OnLoad(JavaVM *vm, void *) try {
     NativeAttrStorage::register_native(env);
     NativeAccessControl::register_native(env);
     NativeAnjayDownload::register_native(env);
+    NativeAnjaySend::register_native(env);
     NativeFirmwareUpdate::register_native(env);
     NativeLog::register_native(env);
     return jni::Unwrap(jni::jni_version_1_6);
@@ -0,0 +1,101 @@
+/*
+ * Copyright 2020-2024 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+/**
+ * Unbounded multiple-producer single-consumer queue. Pushing never blocks nor
+ * takes a lock (apart from what the allocator might do), so that producer
+ * threads cannot be stalled by a consumer busy with something else.
+ *
+ * This is the intrusive queue design by Dmitry Vyukov: producers swap
+ * themselves in as the new head with an atomic exchange, and the consumer
+ * follows the next pointers from the tail. An additional atomic counter
+ * tracks the number of elements.
+ */
+template <typename T>
+class MpscQueue {
+    struct Node {
+        std::atomic<Node *> next;
+        T value;
+
+        Node() : next(nullptr), value() {}
+        explicit Node(T &&value) : next(nullptr), value(std::move(value)) {}
+    };
+
+    std::atomic<Node *> head_;
+    // Only accessed by the consumer.
+    Node *tail_;
+    std::atomic<size_t> size_;
+
+    MpscQueue(const MpscQueue &) = delete;
+    MpscQueue &operator=(const MpscQueue &) = delete;
+
+public:
+    MpscQueue() : head_(new Node()), tail_(head_.load()), size_(0) {}
+
+    ~MpscQueue() {
+        T value;
+        while (pop(&value)) {
+        }
+        delete tail_;
+    }
+
+    /**
+     * May be called from any thread.
+     *
+     * @returns true if the queue was empty before, i.e. the consumer may need
+     *          to be woken up.
+     */
+    bool push(T value) {
+        Node *node = new Node(std::move(value));
+        // Counted before the node becomes reachable, so that the consumer
+        // never decrements the counter below zero.
+        bool was_empty = size_.fetch_add(1, std::memory_order_acq_rel) == 0;
+        Node *prev = head_.exchange(node, std::memory_order_acq_rel);
+        prev->next.store(node, std::memory_order_release);
+        return was_empty;
+    }
+
+    /**
+     * Shall only be called from the consumer thread. May spuriously return
+     * false while a push is in progress; the element will be available on the
+     * next call.
+     */
+    bool pop(T *out_value) {
+        Node *next = tail_->next.load(std::memory_order_acquire);
+        if (!next) {
+            return false;
+        }
+        *out_value = std::move(next->value);
+        delete tail_;
+        tail_ = next;
+        size_.fetch_sub(1, std::memory_order_acq_rel);
+        return true;
+    }
+
+    bool empty() const {
+        return size_.load(std::memory_order_acquire) == 0;
+    }
+
+    size_t size() const {
+        return size_.load(std::memory_order_acquire);
+    }
+};
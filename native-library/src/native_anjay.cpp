@@ -15,11 +15,20 @@
  */
 
 #include <anjay/anjay.h>
+#include <anjay/attr_storage.h>
 
 #include <avsystem/commons/avs_log.h>
+#include <avsystem/commons/avs_sched.h>
 
 #include "./native_anjay.hpp"
 
+#include "./compat/avs_net_socket.hpp"
+#include "./compat/resolver.hpp"
+#include "./compat/socket_address.hpp"
+#include "./global_context.hpp"
+#include "./reconnect_pacer.hpp"
+
+#include "./util_classes/cast_id.hpp"
 #include "./util_classes/exception.hpp"
 
 using namespace std;
@@ -28,8 +37,16 @@ NativeAnjay::NativeAnjay(jni::JNIEnv &,
                          jni::Object<utils::Configuration> &config)
         : endpoint_name_(),
           udp_tx_params_(ANJAY_COAP_DEFAULT_UDP_TX_PARAMS),
+          adaptive_tx_params_(),
+          reconnect_jitter_(AVS_TIME_DURATION_ZERO),
           objects_(),
-          anjay_() {
+          anjay_(),
+          pending_reconnects_(),
+          commands_(),
+          notify_coalescer_(),
+          sample_gate_(std::make_shared<SampleGate>()),
+          observation_watcher_(),
+          observation_listener_() {
     auto config_accessor = utils::Configuration::Accessor{ config };
     auto endpoint_name = config_accessor.get_endpoint_name();
     if (!endpoint_name) {
@@ -56,6 +73,18 @@ NativeAnjay::NativeAnjay(jni::JNIEnv &,
         udp_tx_params_ = *udp_tx_params;
     }
     configuration.udp_tx_params = &udp_tx_params_;
+    adaptive_tx_params_ = config_accessor.get_adaptive_tx_params();
+
+    auto notify_coalescing_window =
+            config_accessor.get_notify_coalescing_window();
+    if (notify_coalescing_window) {
+        notify_coalescer_.emplace(*notify_coalescing_window);
+    }
+
+    auto reconnect_jitter = config_accessor.get_reconnect_jitter();
+    if (reconnect_jitter) {
+        reconnect_jitter_ = *reconnect_jitter;
+    }
 
     auto dtls_hs_params = config_accessor.get_udp_dtls_hs_tx_params();
     if (dtls_hs_params) {
@@ -73,11 +102,32 @@ NativeAnjay::NativeAnjay(jni::JNIEnv &,
         configuration.dtls_version = *dtls_version;
     }
 
+    // Anjay allows LwM2M 1.1 by default when built with it, but applications
+    // have to opt in explicitly, so that enabling it in the build does not
+    // change what is negotiated with existing servers.
+    anjay_lwm2m_version_config_t lwm2m_version_config{
+        ANJAY_LWM2M_VERSION_1_0, ANJAY_LWM2M_VERSION_1_0
+    };
+    auto configured_version_config =
+            config_accessor.get_lwm2m_version_config();
+    if (configured_version_config) {
+        lwm2m_version_config = *configured_version_config;
+    }
+    configuration.lwm2m_version_config = &lwm2m_version_config;
+
     if (!(anjay_ = decltype(anjay_)(anjay_new(&configuration), anjay_delete))) {
         avs_throw(AnjayException(-1, "could not instantiate anjay"));
     }
 }
 
+NativeAnjay::~NativeAnjay() {
+    // The jobs refer to this object, which may be gone before anjay_t is, as
+    // the latter is shared with other native objects.
+    for (PendingReconnect &pending : pending_reconnects_) {
+        avs_sched_del(&pending.handle);
+    }
+}
+
 jni::Local<jni::Array<jni::Object<utils::NativeSocketEntry>>>
 NativeAnjay::get_socket_entries(jni::JNIEnv &env) {
     AVS_LIST(const anjay_socket_entry_t) entries =
@@ -89,6 +139,12 @@ NativeAnjay::get_socket_entries(jni::JNIEnv &env) {
     int index = 0;
     AVS_LIST(const anjay_socket_entry_t) it;
     AVS_LIST_FOREACH(it, entries) {
+        // The event loop fetches the entries after each step, so sockets of
+        // this client get RTT estimation enabled right after being created,
+        // without affecting sockets of other clients.
+        if (adaptive_tx_params_) {
+            compat::enable_rtt_estimation(it->socket);
+        }
         result.Set(env, index++, utils::NativeSocketEntry::New(env, it));
     }
     return result;
@@ -96,32 +152,210 @@ NativeAnjay::get_socket_entries(jni::JNIEnv &env) {
 
 void NativeAnjay::serve(jni::JNIEnv &, jni::jlong socket_ptr) {
     anjay_serve(anjay_.get(), reinterpret_cast<avs_net_socket_t *>(socket_ptr));
+    // A server may have just written attributes into the attribute storage,
+    // which the sample gate has no way to learn.
+    if (sample_gate_->is_storage_installed()
+            && anjay_attr_storage_is_modified(anjay_.get())) {
+        sample_gate_->storage_modified();
+    }
+    check_observations();
+}
+
+jni::jint NativeAnjay::flush_socket(jni::JNIEnv &, jni::jlong socket_ptr) {
+    return avs_is_err(compat::flush_pending_output(
+                   reinterpret_cast<avs_net_socket_t *>(socket_ptr)))
+                   ? -1
+                   : 0;
+}
+
+jni::Local<jni::Object<utils::SocketStats>>
+NativeAnjay::get_socket_stats(jni::JNIEnv &env, jni::jlong socket_ptr) {
+    const compat::AvsSocketBase &backend =
+            *reinterpret_cast<const compat::AvsSocketBase *>(
+                    avs_net_socket_get_system(
+                            reinterpret_cast<avs_net_socket_t *>(socket_ptr)));
+    return utils::SocketStats::New(env, backend.stats());
+}
+
+void NativeAnjay::run_commands() {
+    Command command;
+    while (commands_.pop(&command)) {
+        int result = 0;
+        switch (command.kind) {
+        case Command::Kind::NOTIFY_CHANGED:
+            result = queue_notify_changed(command.oid, command.iid,
+                                          command.rid);
+            break;
+        case Command::Kind::NOTIFY_INSTANCES_CHANGED:
+            result = queue_notify_instances_changed(command.oid);
+            break;
+        case Command::Kind::ENTER_OFFLINE:
+            result = enter_offline(command.transport_set);
+            break;
+        case Command::Kind::RECONNECT:
+            result = paced(command.reconnect);
+            break;
+        }
+        if (result) {
+            avs_log(native_anjay, WARNING, "posted command failed: %d",
+                    result);
+        }
+    }
+}
+
+int NativeAnjay::queue_notify_changed(anjay_oid_t oid,
+                                      anjay_iid_t iid,
+                                      anjay_rid_t rid) {
+    if (!notify_coalescer_) {
+        return anjay_notify_changed(anjay_.get(), oid, iid, rid);
+    }
+    notify_coalescer_->notify_changed(oid, iid, rid);
+    return 0;
+}
+
+int NativeAnjay::queue_notify_instances_changed(anjay_oid_t oid) {
+    if (!notify_coalescer_) {
+        return anjay_notify_instances_changed(anjay_.get(), oid);
+    }
+    notify_coalescer_->notify_instances_changed(oid);
+    return 0;
 }
 
 void NativeAnjay::sched_run(jni::JNIEnv &) {
+    run_commands();
+    if (notify_coalescer_) {
+        int result = notify_coalescer_->flush_if_due(anjay_.get());
+        if (result) {
+            avs_log(native_anjay, WARNING, "could not notify changes: %d",
+                    result);
+        }
+    }
     anjay_sched_run(anjay_.get());
+    check_observations();
+}
+
+void NativeAnjay::check_observations() {
+    observation_watcher_.poll(
+            anjay_.get(),
+            [&](const ObservationWatcher::Path &path,
+                const anjay_resource_observation_status_t &status) {
+                if (!observation_listener_) {
+                    return;
+                }
+                try {
+                    observation_listener_->get_method<void(
+                            jni::Object<utils::ObservationStatus>)>(
+                            "onObservationChanged")(
+                            utils::ObservationStatus::New(
+                                    std::get<0>(path), std::get<1>(path),
+                                    std::get<2>(path), status));
+                } catch (...) {
+                    avs_log_and_clear_exception(WARNING);
+                }
+            });
 }
 
 jni::Local<jni::Object<utils::Duration>>
 NativeAnjay::get_sched_time_to_next(jni::JNIEnv &env) {
+    if (!commands_.empty()) {
+        return utils::Duration::into_java(AVS_TIME_DURATION_ZERO);
+    }
     avs_time_duration_t duration = AVS_TIME_DURATION_INVALID;
     (void) anjay_sched_time_to_next(anjay_.get(), &duration);
+    if (notify_coalescer_) {
+        avs_time_duration_t time_to_flush = notify_coalescer_->time_to_flush();
+        if (avs_time_duration_valid(time_to_flush)
+                && (!avs_time_duration_valid(duration)
+                    || avs_time_duration_less(time_to_flush, duration))) {
+            duration = time_to_flush;
+        }
+    }
     if (!avs_time_duration_valid(duration)) {
         return jni::Local<jni::Object<utils::Duration>>(env, nullptr);
     }
     return utils::Duration::into_java(duration);
 }
 
+int NativeAnjay::DeferredReconnect::run() const {
+    switch (kind) {
+    case Kind::REGISTRATION_UPDATE:
+        return anjay_schedule_registration_update(anjay, ssid);
+    case Kind::TRANSPORT_RECONNECT:
+        return anjay_transport_schedule_reconnect(anjay, transport_set);
+    case Kind::EXIT_OFFLINE:
+        return anjay_transport_exit_offline(anjay, transport_set);
+    }
+    return -1;
+}
+
+void NativeAnjay::DeferredReconnect::merge(const DeferredReconnect &other) {
+    if (ssid != other.ssid) {
+        ssid = ANJAY_SSID_ANY;
+    }
+    transport_set.udp = transport_set.udp || other.transport_set.udp;
+    transport_set.tcp = transport_set.tcp || other.transport_set.tcp;
+}
+
+void NativeAnjay::PendingReconnect::job(avs_sched_t *, const void *context) {
+    const PendingReconnect *pending =
+            *static_cast<const PendingReconnect *const *>(context);
+    if (pending->request.run()) {
+        avs_log(native_anjay, WARNING, "deferred reconnect failed");
+    }
+}
+
+int NativeAnjay::paced(const DeferredReconnect &request) {
+    PendingReconnect &pending =
+            pending_reconnects_[static_cast<size_t>(request.kind)];
+    if (pending.handle) {
+        pending.request.merge(request);
+        return 0;
+    }
+    avs_time_duration_t delay =
+            ReconnectPacer::instance().next_delay(reconnect_jitter_);
+    if (!avs_time_duration_less(AVS_TIME_DURATION_ZERO, delay)) {
+        return request.run();
+    }
+    pending.request = request;
+    const PendingReconnect *context = &pending;
+    return AVS_SCHED_DELAYED(anjay_get_scheduler(anjay_.get()),
+                             &pending.handle, delay, PendingReconnect::job,
+                             &context, sizeof(context));
+}
+
+int NativeAnjay::enter_offline(anjay_transport_set_t transport_set) {
+    // Otherwise, a paced exit_offline() requested earlier would bring the
+    // transports back online shortly after.
+    PendingReconnect &pending = pending_reconnects_[static_cast<size_t>(
+            DeferredReconnect::Kind::EXIT_OFFLINE)];
+    if (pending.handle) {
+        anjay_transport_set_t &pending_set = pending.request.transport_set;
+        pending_set.udp = pending_set.udp && !transport_set.udp;
+        pending_set.tcp = pending_set.tcp && !transport_set.tcp;
+        if (!pending_set.udp && !pending_set.tcp) {
+            avs_sched_del(&pending.handle);
+        }
+    }
+    return anjay_transport_enter_offline(anjay_.get(), transport_set);
+}
+
 jni::jint NativeAnjay::schedule_registration_update(jni::JNIEnv &,
                                                     jni::jint ssid) {
-    return anjay_schedule_registration_update(anjay_.get(), ssid);
+    DeferredReconnect request{};
+    request.anjay = anjay_.get();
+    request.kind = DeferredReconnect::Kind::REGISTRATION_UPDATE;
+    request.ssid = utils::cast_id<anjay_ssid_t>(ssid);
+    return paced(request);
 }
 
 jni::jint NativeAnjay::schedule_transport_reconnect(
         jni::JNIEnv &, jni::Object<utils::NativeTransportSet> &transport_set) {
-    return anjay_transport_schedule_reconnect(
-            anjay_.get(),
-            utils::NativeTransportSet::into_transport_set(transport_set));
+    DeferredReconnect request{};
+    request.anjay = anjay_.get();
+    request.kind = DeferredReconnect::Kind::TRANSPORT_RECONNECT;
+    request.transport_set =
+            utils::NativeTransportSet::into_transport_set(transport_set);
+    return paced(request);
 }
 
 jni::jboolean NativeAnjay::transport_is_offline(
@@ -133,27 +367,229 @@ jni::jboolean NativeAnjay::transport_is_offline(
 
 jni::jint NativeAnjay::transport_enter_offline(
         jni::JNIEnv &, jni::Object<utils::NativeTransportSet> &transport_set) {
-    return anjay_transport_enter_offline(
-            anjay_.get(),
+    return enter_offline(
             utils::NativeTransportSet::into_transport_set(transport_set));
 }
 
 jni::jint NativeAnjay::transport_exit_offline(
         jni::JNIEnv &, jni::Object<utils::NativeTransportSet> &transport_set) {
-    return anjay_transport_exit_offline(
+    DeferredReconnect request{};
+    request.anjay = anjay_.get();
+    request.kind = DeferredReconnect::Kind::EXIT_OFFLINE;
+    request.transport_set =
+            utils::NativeTransportSet::into_transport_set(transport_set);
+    return paced(request);
+}
+
+jni::jboolean NativeAnjay::post_notify_changed(jni::JNIEnv &,
+                                              jni::jint oid,
+                                              jni::jint iid,
+                                              jni::jint rid) {
+    Command command{};
+    command.kind = Command::Kind::NOTIFY_CHANGED;
+    command.oid = utils::cast_id<anjay_oid_t>(oid);
+    command.iid = utils::cast_id<anjay_iid_t>(iid);
+    command.rid = utils::cast_id<anjay_rid_t>(rid);
+    return commands_.push(command);
+}
+
+jni::jboolean NativeAnjay::post_notify_instances_changed(jni::JNIEnv &,
+                                                        jni::jint oid) {
+    Command command{};
+    command.kind = Command::Kind::NOTIFY_INSTANCES_CHANGED;
+    command.oid = utils::cast_id<anjay_oid_t>(oid);
+    return commands_.push(command);
+}
+
+jni::jboolean NativeAnjay::post_registration_update(jni::JNIEnv &,
+                                                   jni::jint ssid) {
+    Command command{};
+    command.kind = Command::Kind::RECONNECT;
+    command.reconnect.anjay = anjay_.get();
+    command.reconnect.kind = DeferredReconnect::Kind::REGISTRATION_UPDATE;
+    command.reconnect.ssid = utils::cast_id<anjay_ssid_t>(ssid);
+    return commands_.push(command);
+}
+
+jni::jboolean NativeAnjay::post_transport_enter_offline(
+        jni::JNIEnv &, jni::Object<utils::NativeTransportSet> &transport_set) {
+    Command command{};
+    command.kind = Command::Kind::ENTER_OFFLINE;
+    command.transport_set =
+            utils::NativeTransportSet::into_transport_set(transport_set);
+    return commands_.push(command);
+}
+
+jni::jboolean NativeAnjay::post_transport_exit_offline(
+        jni::JNIEnv &, jni::Object<utils::NativeTransportSet> &transport_set) {
+    Command command{};
+    command.kind = Command::Kind::RECONNECT;
+    command.reconnect.anjay = anjay_.get();
+    command.reconnect.kind = DeferredReconnect::Kind::EXIT_OFFLINE;
+    command.reconnect.transport_set =
+            utils::NativeTransportSet::into_transport_set(transport_set);
+    return commands_.push(command);
+}
+
+jni::jboolean NativeAnjay::ingest_sample(jni::JNIEnv &,
+                                        jni::jint oid,
+                                        jni::jint iid,
+                                        jni::jint rid,
+                                        jni::jdouble value,
+                                        jni::jlong timestamp_ns) {
+    Command command{};
+    command.kind = Command::Kind::NOTIFY_CHANGED;
+    command.oid = utils::cast_id<anjay_oid_t>(oid);
+    command.iid = utils::cast_id<anjay_iid_t>(iid);
+    command.rid = utils::cast_id<anjay_rid_t>(rid);
+    if (!sample_gate_->accept(command.oid, command.iid, command.rid, value,
+                              timestamp_ns)) {
+        return false;
+    }
+    return commands_.push(command);
+}
+
+void NativeAnjay::set_sample_attrs(jni::JNIEnv &,
+                                   jni::jint ssid,
+                                   jni::jint oid,
+                                   jni::jint iid,
+                                   jni::jint rid,
+                                   jni::Object<utils::ResourceAttrs> &attrs) {
+    anjay_ssid_t anjay_ssid = utils::cast_id<anjay_ssid_t>(ssid);
+    anjay_oid_t anjay_oid = utils::cast_id<anjay_oid_t>(oid);
+    anjay_iid_t anjay_iid = utils::cast_id<anjay_iid_t>(iid);
+    anjay_rid_t anjay_rid = utils::cast_id<anjay_rid_t>(rid);
+    if (attrs.get()) {
+        sample_gate_->set_attrs(anjay_ssid, anjay_oid, anjay_iid, anjay_rid,
+                                utils::ResourceAttrs::into_native(attrs));
+    } else {
+        sample_gate_->clear_attrs(anjay_ssid, anjay_oid, anjay_iid, anjay_rid);
+    }
+}
+
+jni::Local<jni::Object<utils::ObservationStatus>>
+NativeAnjay::get_observation_status(jni::JNIEnv &,
+                                    jni::jint oid,
+                                    jni::jint iid,
+                                    jni::jint rid) {
+    anjay_oid_t anjay_oid = utils::cast_id<anjay_oid_t>(oid);
+    anjay_iid_t anjay_iid = utils::cast_id<anjay_iid_t>(iid);
+    anjay_rid_t anjay_rid = utils::cast_id<anjay_rid_t>(rid);
+    return utils::ObservationStatus::New(
+            anjay_oid, anjay_iid, anjay_rid,
+            anjay_resource_observation_status(anjay_.get(), anjay_oid,
+                                              anjay_iid, anjay_rid));
+}
+
+jni::Local<jni::Array<jni::Object<utils::ObservationStatus>>>
+NativeAnjay::get_observed_resources(jni::JNIEnv &env) {
+    const auto &watched = observation_watcher_.watched();
+    size_t size = 0;
+    for (const auto &entry : watched) {
+        if (entry.second.is_observed) {
+            ++size;
+        }
+    }
+    auto result =
+            jni::Array<jni::Object<utils::ObservationStatus>>::New(env, size);
+    int index = 0;
+    for (const auto &entry : watched) {
+        if (entry.second.is_observed) {
+            result.Set(env, index++,
+                       utils::ObservationStatus::New(
+                               std::get<0>(entry.first),
+                               std::get<1>(entry.first),
+                               std::get<2>(entry.first), entry.second));
+        }
+    }
+    return result;
+}
+
+void NativeAnjay::watch_observation(jni::JNIEnv &,
+                                    jni::jint oid,
+                                    jni::jint iid,
+                                    jni::jint rid) {
+    observation_watcher_.watch(
             anjay_.get(),
-            utils::NativeTransportSet::into_transport_set(transport_set));
+            ObservationWatcher::Path(utils::cast_id<anjay_oid_t>(oid),
+                                     utils::cast_id<anjay_iid_t>(iid),
+                                     utils::cast_id<anjay_rid_t>(rid)));
+}
+
+void NativeAnjay::unwatch_observation(jni::JNIEnv &,
+                                      jni::jint oid,
+                                      jni::jint iid,
+                                      jni::jint rid) {
+    observation_watcher_.unwatch(ObservationWatcher::Path(
+            utils::cast_id<anjay_oid_t>(oid), utils::cast_id<anjay_iid_t>(iid),
+            utils::cast_id<anjay_rid_t>(rid)));
+}
+
+void NativeAnjay::set_observation_listener(
+        jni::JNIEnv &, jni::Object<utils::ObservationListener> &listener) {
+    if (listener.get()) {
+        observation_listener_.emplace(listener);
+    } else {
+        observation_listener_.reset();
+    }
+}
+
+void NativeAnjay::set_reconnect_rate_limit(jni::JNIEnv &,
+                                           jni::Class<NativeAnjay> &,
+                                           jni::jdouble requests_per_second) {
+    ReconnectPacer::instance().set_rate_limit(requests_per_second);
+}
+
+void NativeAnjay::set_host_resolver(jni::JNIEnv &,
+                                    jni::Class<NativeAnjay> &,
+                                    jni::Object<utils::HostResolver> &resolver,
+                                    jni::jlong cache_ttl_ms) {
+    typedef jni::Array<jni::Object<compat::InetAddress>> InetAddressArray;
+
+    compat::Resolver::LookupFunction lookup;
+    if (resolver.get()) {
+        auto accessor =
+                std::make_shared<utils::AccessorBase<utils::HostResolver>>(
+                        resolver);
+        lookup = [accessor](const std::string &host) {
+            // Keep the worker thread attached for the whole lookup, so that
+            // the exception is still pending when it gets logged.
+            return GlobalContext::call_with_env([&](auto &&env) {
+                compat::Resolver::Addresses result;
+                try {
+                    auto addresses =
+                            accessor->get_method<InetAddressArray(jni::String)>(
+                                    "resolve")(
+                                    jni::Make<jni::String>(*env, host));
+                    for (jni::jsize i = 0;
+                         addresses.get() && i < addresses.Length(*env);
+                         ++i) {
+                        result.push_back(
+                                compat::InetAddress(addresses.Get(*env, i))
+                                        .get_address());
+                    }
+                } catch (jni::PendingJavaException &) {
+                    avs_log_and_clear_exception(DEBUG);
+                    result.clear();
+                }
+                return result;
+            });
+        };
+    }
+    compat::Resolver::instance().set_lookup_function(
+            std::move(lookup),
+            avs_time_duration_from_scalar(cache_ttl_ms, AVS_TIME_MS));
 }
 
 jni::jint NativeAnjay::notify_changed(jni::JNIEnv &,
                                       jni::jint oid,
                                       jni::jint iid,
                                       jni::jint rid) {
-    return anjay_notify_changed(anjay_.get(), oid, iid, rid);
+    return queue_notify_changed(oid, iid, rid);
 }
 
 jni::jint NativeAnjay::notify_instances_changed(jni::JNIEnv &, jni::jint oid) {
-    return anjay_notify_instances_changed(anjay_.get(), oid);
+    return queue_notify_instances_changed(oid);
 }
 
 jni::jint NativeAnjay::disable_server(jni::JNIEnv &, jni::jint ssid) {
@@ -182,6 +618,10 @@ avs_coap_udp_tx_params_t NativeAnjay::get_udp_tx_params() {
     return udp_tx_params_;
 }
 
+bool NativeAnjay::get_adaptive_tx_params() {
+    return adaptive_tx_params_;
+}
+
 jni::jboolean NativeAnjay::has_security_config_for_uri(jni::JNIEnv &env,
                                                        jni::String &uri) {
     if (!uri) {
@@ -199,7 +639,8 @@ jni::jboolean NativeAnjay::has_security_config_for_uri(jni::JNIEnv &env,
 jni::jint
 NativeAnjay::register_object(jni::JNIEnv &,
                              jni::Object<utils::NativeAnjayObject> &object) {
-    auto adapter = make_unique<NativeAnjayObjectAdapter>(anjay_, object);
+    auto adapter = make_unique<NativeAnjayObjectAdapter>(anjay_, sample_gate_,
+                                                         object);
     int result = adapter->install();
     if (!result) {
         objects_.push_back(move(adapter));
@@ -219,6 +660,8 @@ void NativeAnjay::register_native(jni::JNIEnv &env) {
             "cleanup",
             METHOD(&NativeAnjay::get_socket_entries, "anjayGetSocketEntries"),
             METHOD(&NativeAnjay::serve, "anjayServe"),
+            METHOD(&NativeAnjay::flush_socket, "anjayFlushSocket"),
+            METHOD(&NativeAnjay::get_socket_stats, "anjayGetSocketStats"),
             METHOD(&NativeAnjay::sched_run, "anjaySchedRun"),
             METHOD(&NativeAnjay::get_sched_time_to_next, "anjaySchedTimeToNext"),
             METHOD(&NativeAnjay::schedule_registration_update, "anjayScheduleRegistrationUpdate"),
@@ -231,6 +674,18 @@ void NativeAnjay::register_native(jni::JNIEnv &env) {
             METHOD(&NativeAnjay::transport_exit_offline, "anjayTransportExitOffline"),
             METHOD(&NativeAnjay::notify_changed, "anjayNotifyChanged"),
             METHOD(&NativeAnjay::notify_instances_changed, "anjayNotifyInstancesChanged"),
+            METHOD(&NativeAnjay::post_notify_changed, "anjayPostNotifyChanged"),
+            METHOD(&NativeAnjay::post_notify_instances_changed, "anjayPostNotifyInstancesChanged"),
+            METHOD(&NativeAnjay::post_registration_update, "anjayPostRegistrationUpdate"),
+            METHOD(&NativeAnjay::post_transport_enter_offline, "anjayPostTransportEnterOffline"),
+            METHOD(&NativeAnjay::post_transport_exit_offline, "anjayPostTransportExitOffline"),
+            METHOD(&NativeAnjay::ingest_sample, "anjayIngestSample"),
+            METHOD(&NativeAnjay::set_sample_attrs, "anjaySetSampleAttrs"),
+            METHOD(&NativeAnjay::get_observation_status, "anjayGetObservationStatus"),
+            METHOD(&NativeAnjay::get_observed_resources, "anjayGetObservedResources"),
+            METHOD(&NativeAnjay::watch_observation, "anjayWatchObservation"),
+            METHOD(&NativeAnjay::unwatch_observation, "anjayUnwatchObservation"),
+            METHOD(&NativeAnjay::set_observation_listener, "anjaySetObservationListener"),
             METHOD(&NativeAnjay::register_object, "anjayRegisterObject"),
             METHOD(&NativeAnjay::has_security_config_for_uri, "anjayHasSecurityConfigForUri")
     );
@@ -240,6 +695,8 @@ void NativeAnjay::register_native(jni::JNIEnv &env) {
 
     jni::RegisterNatives(
             env, *jni::Class<NativeAnjay>::Find(env),
+            STATIC_METHOD(&NativeAnjay::set_reconnect_rate_limit, "setReconnectRateLimit"),
+            STATIC_METHOD(&NativeAnjay::set_host_resolver, "setHostResolver"),
             STATIC_METHOD(&NativeAnjay::get_version, "getVersion"),
             STATIC_METHOD(&NativeAnjay::get_ssid_any, "getSsidAny"),
             STATIC_METHOD(&NativeAnjay::get_id_invalid, "getIdInvalid"),
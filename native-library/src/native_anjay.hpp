@@ -18,28 +18,110 @@
 
 #include "./jni_wrapper.hpp"
 
+#include <array>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
 #include <anjay/anjay.h>
 
+#include <avsystem/commons/avs_sched.h>
+
+#include "./mpsc_queue.hpp"
 #include "./native_anjay_object_adapter.hpp"
+#include "./notify_coalescer.hpp"
+#include "./observation_watcher.hpp"
+#include "./sample_gate.hpp"
 
 #include "./util_classes/accessor_base.hpp"
+#include "./util_classes/attributes.hpp"
 #include "./util_classes/configuration.hpp"
 #include "./util_classes/duration.hpp"
+#include "./util_classes/host_resolver.hpp"
 #include "./util_classes/native_anjay_object.hpp"
 #include "./util_classes/native_socket_entry.hpp"
 #include "./util_classes/native_transport_set.hpp"
+#include "./util_classes/observation_status.hpp"
+#include "./util_classes/socket_stats.hpp"
 #include "./util_classes/transport.hpp"
 
 class NativeAnjay {
     std::string endpoint_name_;
     avs_coap_udp_tx_params_t udp_tx_params_;
+    bool adaptive_tx_params_;
+    avs_time_duration_t reconnect_jitter_;
     std::vector<std::unique_ptr<NativeAnjayObjectAdapter>> objects_;
     std::shared_ptr<anjay_t> anjay_;
 
+    struct DeferredReconnect {
+        enum class Kind {
+            REGISTRATION_UPDATE,
+            TRANSPORT_RECONNECT,
+            EXIT_OFFLINE
+        };
+
+        anjay_t *anjay;
+        Kind kind;
+        anjay_ssid_t ssid;
+        anjay_transport_set_t transport_set;
+
+        int run() const;
+
+        // Extends the request so that it also covers other, of the same kind.
+        void merge(const DeferredReconnect &other);
+    };
+
+    // Paced request waiting in the scheduler. There is at most one per kind;
+    // further requests are merged into it instead of scheduling another job.
+    struct PendingReconnect {
+        DeferredReconnect request;
+        avs_sched_handle_t handle;
+
+        static void job(avs_sched_t *sched, const void *context);
+    };
+
+    std::array<PendingReconnect, 3> pending_reconnects_;
+
+    // Request posted from another thread, executed on the next sched_run().
+    struct Command {
+        enum class Kind {
+            NOTIFY_CHANGED,
+            NOTIFY_INSTANCES_CHANGED,
+            ENTER_OFFLINE,
+            RECONNECT
+        };
+
+        Kind kind;
+        anjay_oid_t oid;
+        anjay_iid_t iid;
+        anjay_rid_t rid;
+        anjay_transport_set_t transport_set;
+        DeferredReconnect reconnect;
+    };
+
+    MpscQueue<Command> commands_;
+    // Set if notifications shall be coalesced; see Configuration.
+    std::optional<NotifyCoalescer> notify_coalescer_;
+    // Shared with the Object adapters and the attribute storage, which feed it
+    // with attributes.
+    std::shared_ptr<SampleGate> sample_gate_;
+    ObservationWatcher observation_watcher_;
+    std::optional<utils::AccessorBase<utils::ObservationListener>>
+            observation_listener_;
+
+    int paced(const DeferredReconnect &request);
+
+    int enter_offline(anjay_transport_set_t transport_set);
+
+    void run_commands();
+
+    void check_observations();
+
+    int queue_notify_changed(anjay_oid_t oid, anjay_iid_t iid, anjay_rid_t rid);
+
+    int queue_notify_instances_changed(anjay_oid_t oid);
+
 public:
     static constexpr auto Name() {
         return "com/avsystem/anjay/impl/NativeAnjay";
@@ -56,6 +138,8 @@ public:
 
     NativeAnjay(jni::JNIEnv &env, jni::Object<utils::Configuration> &config);
 
+    ~NativeAnjay();
+
     std::shared_ptr<anjay_t> get_anjay() {
         return anjay_;
     }
@@ -65,6 +149,11 @@ public:
 
     void serve(jni::JNIEnv &, jni::jlong socket_ptr);
 
+    jni::jint flush_socket(jni::JNIEnv &, jni::jlong socket_ptr);
+
+    jni::Local<jni::Object<utils::SocketStats>>
+    get_socket_stats(jni::JNIEnv &env, jni::jlong socket_ptr);
+
     void sched_run(jni::JNIEnv &);
 
     jni::Local<jni::Object<utils::Duration>>
@@ -105,11 +194,81 @@ public:
     jni::jint register_object(jni::JNIEnv &env,
                               jni::Object<utils::NativeAnjayObject> &object);
 
+    jni::jboolean post_notify_changed(jni::JNIEnv &env,
+                                      jni::jint oid,
+                                      jni::jint iid,
+                                      jni::jint rid);
+
+    jni::jboolean post_notify_instances_changed(jni::JNIEnv &env,
+                                                jni::jint oid);
+
+    jni::jboolean post_registration_update(jni::JNIEnv &env, jni::jint ssid);
+
+    jni::jboolean post_transport_enter_offline(
+            jni::JNIEnv &env,
+            jni::Object<utils::NativeTransportSet> &transport_set);
+
+    jni::jboolean post_transport_exit_offline(
+            jni::JNIEnv &env,
+            jni::Object<utils::NativeTransportSet> &transport_set);
+
+    jni::jboolean ingest_sample(jni::JNIEnv &env,
+                                jni::jint oid,
+                                jni::jint iid,
+                                jni::jint rid,
+                                jni::jdouble value,
+                                jni::jlong timestamp_ns);
+
+    void set_sample_attrs(jni::JNIEnv &env,
+                          jni::jint ssid,
+                          jni::jint oid,
+                          jni::jint iid,
+                          jni::jint rid,
+                          jni::Object<utils::ResourceAttrs> &attrs);
+
+    jni::Local<jni::Object<utils::ObservationStatus>>
+    get_observation_status(jni::JNIEnv &env,
+                           jni::jint oid,
+                           jni::jint iid,
+                           jni::jint rid);
+
+    jni::Local<jni::Array<jni::Object<utils::ObservationStatus>>>
+    get_observed_resources(jni::JNIEnv &env);
+
+    void watch_observation(jni::JNIEnv &env,
+                           jni::jint oid,
+                           jni::jint iid,
+                           jni::jint rid);
+
+    void unwatch_observation(jni::JNIEnv &env,
+                             jni::jint oid,
+                             jni::jint iid,
+                             jni::jint rid);
+
+    void set_observation_listener(
+            jni::JNIEnv &env,
+            jni::Object<utils::ObservationListener> &listener);
+
+    std::shared_ptr<SampleGate> get_sample_gate() {
+        return sample_gate_;
+    }
+
     avs_coap_udp_tx_params_t get_udp_tx_params();
 
+    bool get_adaptive_tx_params();
+
     jni::jboolean has_security_config_for_uri(jni::JNIEnv &env,
                                               jni::String &uri);
 
+    static void set_reconnect_rate_limit(jni::JNIEnv &env,
+                                         jni::Class<NativeAnjay> &,
+                                         jni::jdouble requests_per_second);
+
+    static void set_host_resolver(jni::JNIEnv &env,
+                                  jni::Class<NativeAnjay> &,
+                                  jni::Object<utils::HostResolver> &resolver,
+                                  jni::jlong cache_ttl_ms);
+
     static jni::Local<jni::String> get_version(jni::JNIEnv &env,
                                                jni::Class<NativeAnjay> &) {
         return jni::Make<jni::String>(env, anjay_get_version());
@@ -21,14 +21,23 @@
 #include "./util_classes/download_result_details.hpp"
 #include "./util_classes/security_config.hpp"
 
+#include "./compat/rtt_estimator.hpp"
+
 #include "global_context.hpp"
 
+#include <cstring>
+
 NativeAnjayDownload::NativeAnjayDownload(
         jni::JNIEnv &env,
         const jni::Object<NativeAnjay> &anjay,
         const jni::Object<utils::DownloadConfiguration> &config,
         const jni::Object<utils::DownloadHandlers> &handlers)
-        : anjay_(), accessor_(handlers) {
+        : anjay_(),
+          accessor_(handlers),
+          handlers_(jni::NewGlobal(env, handlers)),
+          block_views_(/* read_only = */ true),
+          etag_(),
+          etag_java_() {
     auto native_anjay = NativeAnjay::into_native(anjay);
     anjay_ = native_anjay->get_anjay();
 
@@ -53,6 +62,10 @@ NativeAnjayDownload::NativeAnjayDownload(
     }
 
     auto coap_tx_params = config_accessor.get_coap_tx_params();
+    if (!coap_tx_params && native_anjay->get_adaptive_tx_params()) {
+        coap_tx_params = compat::RttRegistry::instance().tx_params_for_url(
+                native_anjay->get_udp_tx_params(), url->c_str());
+    }
     if (coap_tx_params) {
         download_config.coap_tx_params = &*coap_tx_params;
     }
@@ -84,34 +97,49 @@ NativeAnjayDownload::~NativeAnjayDownload() {
     }
 }
 
+utils::Optional &NativeAnjayDownload::java_etag(jni::JNIEnv &env,
+                                                const anjay_etag_t *etag) {
+    const bool unchanged =
+            etag_java_ && etag_.has_value() == !!etag
+            && (!etag
+                || (etag_->size() == etag->size
+                    && !memcmp(etag_->data(), etag->value, etag->size)));
+    if (unchanged) {
+        return *etag_java_;
+    }
+    if (etag) {
+        etag_.emplace(etag->value, etag->value + etag->size);
+        std::vector<jni::jbyte> etag_vec(etag_->begin(), etag_->end());
+        etag_java_.emplace(utils::Optional::of(
+                jni::Make<jni::Array<jni::jbyte>>(env, etag_vec)));
+    } else {
+        etag_.reset();
+        etag_java_.emplace(utils::Optional::empty());
+    }
+    return *etag_java_;
+}
+
 avs_error_t NativeAnjayDownload::next_block_handler(anjay_t *,
                                                     const uint8_t *data,
                                                     size_t data_size,
                                                     const anjay_etag_t *etag,
                                                     void *user_data) try {
     return GlobalContext::call_with_env([=](jni::UniqueEnv &&env) {
-        std::vector<jni::jbyte> buffer(data, data + data_size);
-
-        auto make_etag = [&](const anjay_etag_t *etag) {
-            if (etag) {
-                std::vector<jni::jbyte> etag_vec(etag->value,
-                                                 etag->value + etag->size);
-                return utils::Optional::of(
-                        jni::Make<jni::Array<jni::jbyte>>(*env, etag_vec));
-            } else {
-                return utils::Optional::empty();
-            }
-        };
+        static const auto on_next_block =
+                jni::Class<utils::DownloadHandlers>::Singleton(*env)
+                        .GetMethod<void(jni::Object<utils::ByteBuffer>,
+                                        jni::Object<utils::Optional>)>(
+                                *env, "onNextBlock");
 
         NativeAnjayDownload *obj =
                 static_cast<NativeAnjayDownload *>(user_data);
 
-        std::vector<jni::jbyte> data_vec(data, data + data_size);
-        obj->accessor_.get_method<void(jni::Array<jni::jbyte>,
-                                       jni::Object<utils::Optional>)>(
-                "onNextBlock")(jni::Make<jni::Array<jni::jbyte>>(*env,
-                                                                 data_vec),
-                               make_etag(etag).into_java());
+        // The view is read-only, so casting away const is safe here. It is
+        // only valid during this call, which is documented on the Java side.
+        auto &block = obj->block_views_.view(const_cast<uint8_t *>(data),
+                                             data_size);
+        obj->handlers_.Call(*env, on_next_block, block,
+                            obj->java_etag(*env, etag).into_java());
         return AVS_OK;
     });
 } catch (...) {
@@ -21,15 +21,29 @@
 #include "./native_anjay.hpp"
 
 #include "./util_classes/accessor_base.hpp"
+#include "./util_classes/byte_buffer.hpp"
 #include "./util_classes/download_configuration.hpp"
 #include "./util_classes/download_handlers.hpp"
+#include "./util_classes/optional.hpp"
 
 #include <anjay/download.h>
 
+#include <optional>
+#include <vector>
+
 class NativeAnjayDownload {
     std::weak_ptr<anjay_t> anjay_;
     anjay_download_handle_t handle_;
     utils::AccessorBase<utils::DownloadHandlers> accessor_;
+    jni::Global<jni::Object<utils::DownloadHandlers>> handlers_;
+
+    // Blocks are passed to Java as read-only views over Anjay's own buffer,
+    // and the ETag is only converted to a Java object when it changes.
+    utils::BufferViewCache block_views_;
+    std::optional<std::vector<uint8_t>> etag_;
+    std::optional<utils::Optional> etag_java_;
+
+    utils::Optional &java_etag(jni::JNIEnv &env, const anjay_etag_t *etag);
 
     static avs_error_t next_block_handler(anjay_t *anjay,
                                           const uint8_t *data,
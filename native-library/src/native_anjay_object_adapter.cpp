@@ -18,10 +18,12 @@
 
 NativeAnjayObjectAdapter::NativeAnjayObjectAdapter(
         const std::weak_ptr<anjay_t> &anjay,
+        const std::shared_ptr<SampleGate> &sample_gate,
         const jni::Object<utils::NativeAnjayObject> &object)
         : def_(),
           def_ptr_(&def_),
           anjay_(anjay),
+          sample_gate_(sample_gate),
           accessor_(std::move(object)),
           version_() {
     def_.oid = accessor_.get_oid();
@@ -313,7 +315,11 @@ int NativeAnjayObjectAdapter::resource_write_attrs(
         anjay_ssid_t ssid,
         const anjay_dm_r_attributes_t *attrs) try {
     auto &self = *get_obj(obj_ptr);
-    return self.accessor_.resource_write_attrs(iid, rid, ssid, attrs);
+    int result = self.accessor_.resource_write_attrs(iid, rid, ssid, attrs);
+    if (!result) {
+        self.sample_gate_->set_attrs(ssid, self.def_.oid, iid, rid, *attrs);
+    }
+    return result;
 } catch (...) {
     avs_log_and_clear_exception(DEBUG);
     return -1;
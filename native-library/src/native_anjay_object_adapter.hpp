@@ -22,6 +22,9 @@
 
 #include "util_classes/native_anjay_object.hpp"
 
+#include "./sample_gate.hpp"
+
+#include <memory>
 #include <string>
 
 class NativeAnjayObjectAdapter {
@@ -29,6 +32,7 @@ class NativeAnjayObjectAdapter {
     const anjay_dm_object_def_t *const def_ptr_;
 
     std::weak_ptr<anjay_t> anjay_;
+    std::shared_ptr<SampleGate> sample_gate_;
     utils::NativeAnjayObject::Accessor accessor_;
     std::string version_;
 
@@ -163,8 +167,9 @@ class NativeAnjayObjectAdapter {
                                   const anjay_dm_r_attributes_t *attrs);
 
 public:
-    explicit NativeAnjayObjectAdapter(
+    NativeAnjayObjectAdapter(
             const std::weak_ptr<anjay_t> &anjay,
+            const std::shared_ptr<SampleGate> &sample_gate,
             const jni::Object<utils::NativeAnjayObject> &object);
     ~NativeAnjayObjectAdapter();
 
@@ -0,0 +1,245 @@
+/*
+ * Copyright 2020-2024 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <new>
+
+#include "./native_anjay_send.hpp"
+#include "./util_classes/cast_id.hpp"
+#include "./util_classes/exception.hpp"
+#include "./util_classes/send_result.hpp"
+
+#include "global_context.hpp"
+
+namespace {
+
+struct SendContext {
+    std::weak_ptr<utils::AccessorBase<utils::SendHandlers>> handlers;
+    size_t samples;
+};
+
+void report(utils::AccessorBase<utils::SendHandlers> &handlers,
+            size_t samples,
+            jni::Local<jni::Object<utils::SendResult>> result,
+            int details) {
+    handlers.get_method<void(jni::jint, jni::Object<utils::SendResult>,
+                             jni::jint)>("onSendFinished")(
+            static_cast<jni::jint>(samples), result, details);
+}
+
+} // namespace
+
+NativeAnjaySend::NativeAnjaySend(
+        jni::JNIEnv &env,
+        const jni::Object<NativeAnjay> &anjay,
+        const jni::Object<utils::SendConfiguration> &config,
+        const jni::Object<utils::SendHandlers> &handlers)
+        : anjay_(NativeAnjay::into_native(anjay)->get_anjay()),
+          ssid_(),
+          max_samples_(),
+          max_delay_(),
+          handlers_(std::make_shared<Handlers>(handlers)),
+          builder_(),
+          samples_(),
+          flush_job_() {
+    auto config_accessor = utils::SendConfiguration::Accessor{ config };
+
+    ssid_ = utils::cast_id<anjay_ssid_t>(config_accessor.get_ssid());
+    if (ssid_ == ANJAY_SSID_ANY || ssid_ == ANJAY_SSID_BOOTSTRAP) {
+        avs_throw(IllegalArgumentException(env, "ssid MUST be set"));
+    }
+    int max_samples = config_accessor.get_max_samples();
+    if (max_samples <= 0) {
+        avs_throw(IllegalArgumentException(env,
+                                           "maxSamples MUST be positive"));
+    }
+    max_samples_ = static_cast<size_t>(max_samples);
+    max_delay_ = config_accessor.get_max_delay();
+}
+
+NativeAnjaySend::~NativeAnjaySend() {
+    // The scheduler clears the handle when it drops the job, so this is safe
+    // even if anjay_t has already been deleted.
+    avs_sched_del(&flush_job_);
+    anjay_send_batch_builder_cleanup(&builder_);
+}
+
+template <typename Adder>
+void NativeAnjaySend::add(jni::JNIEnv &env,
+                          jni::jint oid,
+                          jni::jint iid,
+                          jni::jint rid,
+                          jni::jlong timestamp_ms,
+                          Adder &&adder) {
+    auto locked = anjay_.lock();
+    if (!locked) {
+        avs_throw(IllegalStateException(env, "anjay object expired"));
+    }
+    if (!builder_ && !(builder_ = anjay_send_batch_builder_new())) {
+        avs_throw(std::bad_alloc());
+    }
+    // Scheduled before the sample is added, so that a failure leaves the
+    // batch unchanged. A job left over from a failed add() is reused.
+    if (!samples_ && max_delay_ && !flush_job_) {
+        NativeAnjaySend *self = this;
+        if (AVS_SCHED_DELAYED(anjay_get_scheduler(locked.get()), &flush_job_,
+                              *max_delay_, flush_job, &self, sizeof(self))) {
+            avs_throw(AnjayException(-1, "could not schedule batch flush"));
+        }
+    }
+    avs_time_real_t timestamp{ avs_time_duration_from_scalar(timestamp_ms,
+                                                             AVS_TIME_MS) };
+    int result = adder(builder_, utils::cast_id<anjay_oid_t>(oid),
+                       utils::cast_id<anjay_iid_t>(iid),
+                       utils::cast_id<anjay_rid_t>(rid), timestamp);
+    if (result) {
+        avs_throw(AnjayException(result, "could not add sample to batch"));
+    }
+    if (++samples_ >= max_samples_) {
+        flush_batch(locked.get());
+    }
+}
+
+void NativeAnjaySend::flush_batch(anjay_t *anjay) {
+    avs_sched_del(&flush_job_);
+    if (!samples_) {
+        return;
+    }
+    size_t samples = samples_;
+    samples_ = 0;
+
+    anjay_send_batch_t *batch = anjay_send_batch_builder_compile(&builder_);
+    if (!batch) {
+        anjay_send_batch_builder_cleanup(&builder_);
+        report(*handlers_, samples, utils::SendResult::failed(),
+               ANJAY_SEND_ERR_INTERNAL);
+        return;
+    }
+    auto context = std::make_unique<SendContext>(
+            SendContext{ handlers_, samples });
+    // Deferrable, so that samples collected while the server is unreachable
+    // are delivered once the connection is back rather than dropped.
+    anjay_send_result_t result =
+            anjay_send_deferrable(anjay, ssid_, batch, send_finished_handler,
+                                  context.get());
+    anjay_send_batch_release(&batch);
+    if (result == ANJAY_SEND_OK) {
+        context.release();
+    } else {
+        report(*handlers_, samples, utils::SendResult::failed(), result);
+    }
+}
+
+void NativeAnjaySend::flush_job(avs_sched_t *, const void *context) try {
+    NativeAnjaySend *self = *static_cast<NativeAnjaySend *const *>(context);
+    if (auto locked = self->anjay_.lock()) {
+        self->flush_batch(locked.get());
+    }
+} catch (...) {
+    avs_log_and_clear_exception(DEBUG);
+}
+
+void NativeAnjaySend::send_finished_handler(anjay_t *,
+                                            anjay_ssid_t,
+                                            const anjay_send_batch_t *,
+                                            int result,
+                                            void *data) try {
+    std::unique_ptr<SendContext> context(static_cast<SendContext *>(data));
+    if (auto handlers = context->handlers.lock()) {
+        report(*handlers, context->samples,
+               utils::SendResult::into_java(result), result > 0 ? result : 0);
+    }
+} catch (...) {
+    avs_log_and_clear_exception(DEBUG);
+}
+
+void NativeAnjaySend::add_long(jni::JNIEnv &env,
+                               jni::jint oid,
+                               jni::jint iid,
+                               jni::jint rid,
+                               jni::jlong timestamp_ms,
+                               jni::jlong value) {
+    add(env, oid, iid, rid, timestamp_ms,
+        [=](anjay_send_batch_builder_t *builder, anjay_oid_t oid,
+            anjay_iid_t iid, anjay_rid_t rid, avs_time_real_t timestamp) {
+            return anjay_send_batch_add_int(builder, oid, iid, rid,
+                                            ANJAY_ID_INVALID, timestamp,
+                                            value);
+        });
+}
+
+void NativeAnjaySend::add_double(jni::JNIEnv &env,
+                                 jni::jint oid,
+                                 jni::jint iid,
+                                 jni::jint rid,
+                                 jni::jlong timestamp_ms,
+                                 jni::jdouble value) {
+    add(env, oid, iid, rid, timestamp_ms,
+        [=](anjay_send_batch_builder_t *builder, anjay_oid_t oid,
+            anjay_iid_t iid, anjay_rid_t rid, avs_time_real_t timestamp) {
+            return anjay_send_batch_add_double(builder, oid, iid, rid,
+                                               ANJAY_ID_INVALID, timestamp,
+                                               value);
+        });
+}
+
+void NativeAnjaySend::add_boolean(jni::JNIEnv &env,
+                                  jni::jint oid,
+                                  jni::jint iid,
+                                  jni::jint rid,
+                                  jni::jlong timestamp_ms,
+                                  jni::jboolean value) {
+    add(env, oid, iid, rid, timestamp_ms,
+        [=](anjay_send_batch_builder_t *builder, anjay_oid_t oid,
+            anjay_iid_t iid, anjay_rid_t rid, avs_time_real_t timestamp) {
+            return anjay_send_batch_add_bool(builder, oid, iid, rid,
+                                             ANJAY_ID_INVALID, timestamp,
+                                             value);
+        });
+}
+
+jni::jint NativeAnjaySend::get_pending_samples(jni::JNIEnv &) {
+    return static_cast<jni::jint>(samples_);
+}
+
+void NativeAnjaySend::flush(jni::JNIEnv &env) {
+    if (auto locked = anjay_.lock()) {
+        flush_batch(locked.get());
+    } else {
+        avs_throw(IllegalStateException(env, "anjay object expired"));
+    }
+}
+
+void NativeAnjaySend::register_native(jni::JNIEnv &env) {
+#define METHOD(MethodPtr, name) \
+    jni::MakeNativePeerMethod<decltype(MethodPtr), (MethodPtr)>(name)
+
+    // clang-format off
+    jni::RegisterNativePeer<NativeAnjaySend>(
+            env, jni::Class<NativeAnjaySend>::Find(env), "self",
+            jni::MakePeer<NativeAnjaySend, jni::Object<NativeAnjay> &,
+                          jni::Object<utils::SendConfiguration> &,
+                          jni::Object<utils::SendHandlers> &>,
+            "init",
+            "cleanup",
+            METHOD(&NativeAnjaySend::add_long, "sendAddLong"),
+            METHOD(&NativeAnjaySend::add_double, "sendAddDouble"),
+            METHOD(&NativeAnjaySend::add_boolean, "sendAddBoolean"),
+            METHOD(&NativeAnjaySend::get_pending_samples, "sendGetPendingSamples"),
+            METHOD(&NativeAnjaySend::flush, "sendFlush"));
+    // clang-format on
+
+#undef METHOD
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright 2020-2024 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <memory>
+#include <optional>
+
+#include "./jni_wrapper.hpp"
+
+#include "./native_anjay.hpp"
+
+#include "./util_classes/accessor_base.hpp"
+#include "./util_classes/send_configuration.hpp"
+#include "./util_classes/send_handlers.hpp"
+
+#include <anjay/lwm2m_send.h>
+
+#include <avsystem/commons/avs_sched.h>
+
+class NativeAnjaySend {
+    using Handlers = utils::AccessorBase<utils::SendHandlers>;
+
+    std::weak_ptr<anjay_t> anjay_;
+    anjay_ssid_t ssid_;
+    size_t max_samples_;
+    std::optional<avs_time_duration_t> max_delay_;
+    // Shared with in-flight requests, whose finished handlers may be called
+    // after this object is gone.
+    std::shared_ptr<Handlers> handlers_;
+    anjay_send_batch_builder_t *builder_;
+    size_t samples_;
+    avs_sched_handle_t flush_job_;
+
+    template <typename Adder>
+    void add(jni::JNIEnv &env,
+             jni::jint oid,
+             jni::jint iid,
+             jni::jint rid,
+             jni::jlong timestamp_ms,
+             Adder &&adder);
+
+    void flush_batch(anjay_t *anjay);
+
+    static void flush_job(avs_sched_t *sched, const void *context);
+
+    static void send_finished_handler(anjay_t *anjay,
+                                      anjay_ssid_t ssid,
+                                      const anjay_send_batch_t *batch,
+                                      int result,
+                                      void *data);
+
+    NativeAnjaySend(const NativeAnjaySend &) = delete;
+    NativeAnjaySend &operator=(const NativeAnjaySend &) = delete;
+
+    NativeAnjaySend(NativeAnjaySend &&) = delete;
+    NativeAnjaySend &operator=(NativeAnjaySend &&) = delete;
+
+public:
+    static constexpr auto Name() {
+        return "com/avsystem/anjay/impl/NativeAnjaySend";
+    }
+
+    NativeAnjaySend(jni::JNIEnv &env,
+                    const jni::Object<NativeAnjay> &anjay,
+                    const jni::Object<utils::SendConfiguration> &config,
+                    const jni::Object<utils::SendHandlers> &handlers);
+
+    ~NativeAnjaySend();
+
+    static void register_native(jni::JNIEnv &env);
+
+    void add_long(jni::JNIEnv &env,
+                  jni::jint oid,
+                  jni::jint iid,
+                  jni::jint rid,
+                  jni::jlong timestamp_ms,
+                  jni::jlong value);
+
+    void add_double(jni::JNIEnv &env,
+                    jni::jint oid,
+                    jni::jint iid,
+                    jni::jint rid,
+                    jni::jlong timestamp_ms,
+                    jni::jdouble value);
+
+    void add_boolean(jni::JNIEnv &env,
+                     jni::jint oid,
+                     jni::jint iid,
+                     jni::jint rid,
+                     jni::jlong timestamp_ms,
+                     jni::jboolean value);
+
+    jni::jint get_pending_samples(jni::JNIEnv &env);
+
+    void flush(jni::JNIEnv &env);
+};
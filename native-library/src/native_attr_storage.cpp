@@ -23,15 +23,17 @@
 
 NativeAttrStorage::NativeAttrStorage(jni::JNIEnv &,
                                      const jni::Object<NativeAnjay> &anjay)
-        : anjay_() {
+        : anjay_(), sample_gate_() {
     auto native_anjay = NativeAnjay::into_native(anjay);
     anjay_ = native_anjay->get_anjay();
+    sample_gate_ = native_anjay->get_sample_gate();
     if (auto locked = anjay_.lock()) {
         int result = anjay_attr_storage_install(locked.get());
         if (result) {
             avs_throw(AnjayException(result,
                                      "Could not install Attribute storage"));
         }
+        sample_gate_->storage_installed();
     } else {
         avs_throw(IllegalStateException("anjay object expired"));
     }
@@ -101,6 +103,8 @@ void NativeAttrStorage::set_resource_attrs(
         if (result) {
             avs_throw(AnjayException(result, "could not set attributes"));
         }
+        sample_gate_->set_storage_attrs(anjay_ssid, anjay_oid, anjay_iid,
+                                        anjay_rid, anjay_attrs);
     } else {
         avs_throw(IllegalStateException("anjay object expired"));
     }
@@ -121,6 +125,7 @@ NativeAttrStorage::get_attr_value_none(jni::JNIEnv &,
 void NativeAttrStorage::purge(jni::JNIEnv &) {
     if (auto locked = anjay_.lock()) {
         anjay_attr_storage_purge(locked.get());
+        sample_gate_->storage_purged();
     } else {
         avs_throw(IllegalStateException("anjay object expired"));
     }
@@ -162,6 +167,7 @@ NativeAttrStorage::restore(jni::JNIEnv &,
                                                          stream.get()))) {
             return -1;
         }
+        sample_gate_->storage_modified();
         return 0;
     } else {
         avs_throw(IllegalStateException("anjay object expired"));
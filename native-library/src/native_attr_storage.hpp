@@ -32,6 +32,7 @@
 
 class NativeAttrStorage {
     std::weak_ptr<anjay_t> anjay_;
+    std::shared_ptr<SampleGate> sample_gate_;
 
 public:
     static constexpr auto Name() {
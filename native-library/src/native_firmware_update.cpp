@@ -15,6 +15,7 @@
  */
 
 #include "./native_firmware_update.hpp"
+#include "./compat/rtt_estimator.hpp"
 #include "./util_classes/firmware_update_initial_state.hpp"
 #include "./util_classes/firmware_update_result.hpp"
 
@@ -102,6 +103,10 @@ NativeFirmwareUpdate::get_coap_tx_params(void *user_ptr,
     } catch (...) {
         avs_log_and_clear_exception(DEBUG);
     }
+    if (obj->adaptive_tx_params_) {
+        return compat::RttRegistry::instance().tx_params_for_url(
+                obj->anjay_tx_params_, download_uri);
+    }
     return obj->anjay_tx_params_;
 }
 
@@ -145,6 +150,7 @@ NativeFirmwareUpdate::NativeFirmwareUpdate(
     anjay_ = native_anjay->get_anjay();
 
     anjay_tx_params_ = native_anjay->get_udp_tx_params();
+    adaptive_tx_params_ = native_anjay->get_adaptive_tx_params();
 
     auto state_accessor =
             utils::FirmwareUpdateInitialState::Accessor{ initial_state };
@@ -58,6 +58,7 @@ class NativeFirmwareUpdate {
     std::optional<std::string> version_;
     std::unique_ptr<utils::SecurityConfig> security_config_;
     avs_coap_udp_tx_params_t anjay_tx_params_;
+    bool adaptive_tx_params_;
 
 public:
     static constexpr auto Name() {
@@ -20,10 +20,45 @@
 #include "./native_log.hpp"
 
 #include <iostream>
+#include <new>
+#include <vector>
+
+std::mutex NativeLog::MODE_MUTEX;
+std::unique_ptr<AsyncLogSink> NativeLog::ASYNC_SINK;
+std::atomic<AsyncLogSink *> NativeLog::ACTIVE_ASYNC_SINK;
+std::unique_ptr<LogRingFile> NativeLog::RING;
+std::atomic<LogRingFile *> NativeLog::ACTIVE_RING;
+std::mutex NativeLog::MODULES_MUTEX;
+std::unordered_set<const char *> NativeLog::SEEN_MODULE_NAMES;
+std::unordered_set<std::string> NativeLog::SEEN_MODULES;
+std::vector<std::string> NativeLog::NEW_MODULES;
+std::atomic<bool> NativeLog::HAS_NEW_MODULES;
+
+void NativeLog::note_module(const char *module) {
+    // Called with the avs_log lock held, so the level of the module cannot be
+    // changed from here; Java picks it up later with takeNewModules().
+    // Consecutive messages usually come from the same module, so most calls
+    // end here, without taking the lock.
+    static thread_local const char *last_module = nullptr;
+    if (module == last_module) {
+        return;
+    }
+    last_module = module;
+    std::lock_guard<std::mutex> lock(MODULES_MUTEX);
+    if (SEEN_MODULE_NAMES.find(module) != SEEN_MODULE_NAMES.end()) {
+        return;
+    }
+    SEEN_MODULE_NAMES.insert(module);
+    if (SEEN_MODULES.emplace(module).second) {
+        NEW_MODULES.emplace_back(module);
+        HAS_NEW_MODULES = true;
+    }
+}
 
 void NativeLog::log_handler(avs_log_level_t level,
                             const char *module,
                             const char *message) try {
+    note_module(module);
     GlobalContext::call_with_env([=](jni::UniqueEnv &&env) {
         try {
             const std::string java_module = "Anjay." + std::string(module);
@@ -47,16 +82,167 @@ void NativeLog::log_handler(avs_log_level_t level,
               << message << std::endl;
 }
 
+void NativeLog::async_log_handler(avs_log_level_t level,
+                                  const char *module,
+                                  const char *message) {
+    // avs_log calls handlers with its lock held, and avs_log_set_handler()
+    // takes the same lock, so a sink replaced or removed before that call
+    // returns is no longer in use afterwards.
+    note_module(module);
+    ACTIVE_ASYNC_SINK.load(std::memory_order_acquire)
+            ->post(level, module, message);
+}
+
+void NativeLog::ring_log_handler(avs_log_level_t,
+                                 const char *module,
+                                 const char *message) {
+    note_module(module);
+    ACTIVE_RING.load(std::memory_order_acquire)->append(message);
+}
+
+avs_log_handler_t *NativeLog::current_handler() {
+    if (RING) {
+        return ring_log_handler;
+    } else if (ASYNC_SINK) {
+        return async_log_handler;
+    } else {
+        return log_handler;
+    }
+}
+
 void NativeLog::initialize(jni::JNIEnv &, jni::Class<NativeLog> &) {
-    avs_log_set_default_level(AVS_LOG_TRACE);
-    avs_log_set_handler(log_handler);
+    std::lock_guard<std::mutex> lock(MODE_MUTEX);
+    avs_log_set_handler(current_handler());
+}
+
+void NativeLog::enable_async(jni::JNIEnv &env,
+                             jni::Class<NativeLog> &,
+                             jni::jint capacity) {
+    if (capacity <= 0) {
+        avs_throw(IllegalArgumentException(env, "capacity MUST be positive"));
+    }
+    auto sink = std::make_unique<AsyncLogSink>(static_cast<size_t>(capacity));
+    std::lock_guard<std::mutex> lock(MODE_MUTEX);
+    ACTIVE_ASYNC_SINK.store(sink.get(), std::memory_order_release);
+    ASYNC_SINK.swap(sink);
+    avs_log_set_handler(current_handler());
+    // Only now the previous sink, if any, is guaranteed not to be in use.
+    sink.reset();
+}
+
+void NativeLog::disable_async(jni::JNIEnv &, jni::Class<NativeLog> &) {
+    std::lock_guard<std::mutex> lock(MODE_MUTEX);
+    auto previous = std::move(ASYNC_SINK);
+    avs_log_set_handler(current_handler());
+    ACTIVE_ASYNC_SINK.store(nullptr, std::memory_order_release);
+    previous.reset();
+}
+
+void NativeLog::enable_ring(jni::JNIEnv &env,
+                            jni::Class<NativeLog> &,
+                            jni::String &path,
+                            jni::jlong size) {
+    if (size <= 0) {
+        avs_throw(IllegalArgumentException(env, "size MUST be positive"));
+    }
+    // Built first, so that if it throws, the current mode stays in effect.
+    auto ring = std::make_unique<LogRingFile>(jni::Make<std::string>(env, path),
+                                              static_cast<size_t>(size));
+    std::lock_guard<std::mutex> lock(MODE_MUTEX);
+    ACTIVE_RING.store(ring.get(), std::memory_order_release);
+    RING.swap(ring);
+    avs_log_set_handler(current_handler());
+    // Only now the previous ring, if any, is guaranteed not to be in use.
+    ring.reset();
+}
+
+void NativeLog::disable_ring(jni::JNIEnv &, jni::Class<NativeLog> &) {
+    std::lock_guard<std::mutex> lock(MODE_MUTEX);
+    auto previous = std::move(RING);
+    avs_log_set_handler(current_handler());
+    ACTIVE_RING.store(nullptr, std::memory_order_release);
+    previous.reset();
+}
+
+jni::Local<jni::Array<jni::jbyte>>
+NativeLog::snapshot_ring(jni::JNIEnv &env, jni::Class<NativeLog> &) {
+    std::vector<char> snapshot;
+    {
+        std::lock_guard<std::mutex> lock(MODE_MUTEX);
+        if (!RING) {
+            avs_throw(IllegalStateException(env, "log ring is not enabled"));
+        }
+        snapshot = RING->snapshot();
+    }
+    return jni::Make<jni::Array<jni::jbyte>>(
+            env, std::vector<jni::jbyte>(snapshot.begin(), snapshot.end()));
+}
+
+jni::jlong NativeLog::get_dropped_messages(jni::JNIEnv &,
+                                           jni::Class<NativeLog> &) {
+    std::lock_guard<std::mutex> lock(MODE_MUTEX);
+    return ASYNC_SINK ? static_cast<jni::jlong>(ASYNC_SINK->dropped()) : 0;
+}
+
+jni::Local<jni::Array<jni::String>>
+NativeLog::take_new_modules(jni::JNIEnv &env, jni::Class<NativeLog> &) {
+    if (!HAS_NEW_MODULES.exchange(false)) {
+        return jni::Local<jni::Array<jni::String>>(env, nullptr);
+    }
+    std::vector<std::string> modules;
+    {
+        std::lock_guard<std::mutex> lock(MODULES_MUTEX);
+        modules.swap(NEW_MODULES);
+    }
+    auto result = jni::Array<jni::String>::New(env, modules.size());
+    for (size_t i = 0; i < modules.size(); ++i) {
+        result.Set(env, i, jni::Make<jni::String>(env, modules[i]));
+    }
+    return result;
+}
+
+void NativeLog::set_max_stack_frames(jni::JNIEnv &,
+                                     jni::Class<NativeLog> &,
+                                     jni::jint frames) {
+    utils::set_max_logged_stack_frames(frames);
+}
+
+void NativeLog::set_default_level(jni::JNIEnv &,
+                                  jni::Class<NativeLog> &,
+                                  jni::jint level) {
+    avs_log_set_default_level(utils::Level::threshold_into_native(level));
+}
+
+void NativeLog::set_module_level(jni::JNIEnv &env,
+                                 jni::Class<NativeLog> &,
+                                 jni::String &module,
+                                 jni::jint level) {
+    // avs_log_set_level() stringifies its argument, so the underlying function
+    // has to be used for module names known only at runtime.
+    if (avs_log_set_level__(jni::Make<std::string>(env, module).c_str(),
+                            utils::Level::threshold_into_native(level))) {
+        avs_throw(std::bad_alloc());
+    }
 }
 
 void NativeLog::register_native(jni::JNIEnv &env) {
 #define STATIC_METHOD(MethodPtr, Name) \
     jni::MakeNativeMethod<decltype(MethodPtr), (MethodPtr)>(Name)
 
-    jni::RegisterNatives(env, *jni::Class<NativeLog>::Find(env),
-                         STATIC_METHOD(&NativeLog::initialize, "initialize"));
+    jni::RegisterNatives(
+            env, *jni::Class<NativeLog>::Find(env),
+            STATIC_METHOD(&NativeLog::initialize, "initialize"),
+            STATIC_METHOD(&NativeLog::set_default_level, "setDefaultLevel"),
+            STATIC_METHOD(&NativeLog::set_module_level, "setModuleLevel"),
+            STATIC_METHOD(&NativeLog::enable_async, "enableAsync"),
+            STATIC_METHOD(&NativeLog::disable_async, "disableAsync"),
+            STATIC_METHOD(&NativeLog::get_dropped_messages,
+                          "getDroppedMessages"),
+            STATIC_METHOD(&NativeLog::enable_ring, "openRing"),
+            STATIC_METHOD(&NativeLog::disable_ring, "closeRing"),
+            STATIC_METHOD(&NativeLog::snapshot_ring, "snapshotRing"),
+            STATIC_METHOD(&NativeLog::take_new_modules, "takeNewModules"),
+            STATIC_METHOD(&NativeLog::set_max_stack_frames,
+                          "setMaxStackFrames"));
 #undef STATIC_METHOD
 }
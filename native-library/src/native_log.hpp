@@ -16,17 +16,93 @@
 
 #pragma once
 
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
 #include "./jni_wrapper.hpp"
 
+#include "./async_log_sink.hpp"
+#include "./log_ring_file.hpp"
+
 #include "./util_classes/level.hpp"
 #include "./util_classes/logger.hpp"
 
 class NativeLog {
+    static std::mutex MODE_MUTEX;
+    static std::unique_ptr<AsyncLogSink> ASYNC_SINK;
+    // Sink used by async_log_handler(). Switched to a new sink before the
+    // owning pointer is, and cleared only after the handler is uninstalled.
+    static std::atomic<AsyncLogSink *> ACTIVE_ASYNC_SINK;
+    // Takes precedence over both Java-bound handlers if set.
+    static std::unique_ptr<LogRingFile> RING;
+    // Ring used by ring_log_handler(), switched like ACTIVE_ASYNC_SINK.
+    static std::atomic<LogRingFile *> ACTIVE_RING;
+
+    static std::mutex MODULES_MUTEX;
+    // Addresses of module names passed to the handlers so far. avs_log passes
+    // string literals, so this recognizes known modules without allocating.
+    static std::unordered_set<const char *> SEEN_MODULE_NAMES;
+    // Native modules that have logged anything so far, and the ones among
+    // them not yet returned by take_new_modules().
+    static std::unordered_set<std::string> SEEN_MODULES;
+    static std::vector<std::string> NEW_MODULES;
+    static std::atomic<bool> HAS_NEW_MODULES;
+
+    static void note_module(const char *module);
+
     static void
     log_handler(avs_log_level_t level, const char *module, const char *message);
 
+    static void async_log_handler(avs_log_level_t level,
+                                  const char *module,
+                                  const char *message);
+
+    static void ring_log_handler(avs_log_level_t level,
+                                 const char *module,
+                                 const char *message);
+
+    static avs_log_handler_t *current_handler();
+
     static void initialize(jni::JNIEnv &, jni::Class<NativeLog> &);
 
+    static void
+    set_default_level(jni::JNIEnv &, jni::Class<NativeLog> &, jni::jint level);
+
+    static void set_module_level(jni::JNIEnv &env,
+                                 jni::Class<NativeLog> &,
+                                 jni::String &module,
+                                 jni::jint level);
+
+    static void enable_async(jni::JNIEnv &env,
+                             jni::Class<NativeLog> &,
+                             jni::jint capacity);
+
+    static void disable_async(jni::JNIEnv &, jni::Class<NativeLog> &);
+
+    static jni::jlong get_dropped_messages(jni::JNIEnv &,
+                                           jni::Class<NativeLog> &);
+
+    static void enable_ring(jni::JNIEnv &env,
+                            jni::Class<NativeLog> &,
+                            jni::String &path,
+                            jni::jlong size);
+
+    static void disable_ring(jni::JNIEnv &, jni::Class<NativeLog> &);
+
+    static jni::Local<jni::Array<jni::jbyte>>
+    snapshot_ring(jni::JNIEnv &env, jni::Class<NativeLog> &);
+
+    static jni::Local<jni::Array<jni::String>>
+    take_new_modules(jni::JNIEnv &env, jni::Class<NativeLog> &);
+
+    static void set_max_stack_frames(jni::JNIEnv &,
+                                     jni::Class<NativeLog> &,
+                                     jni::jint frames);
+
 public:
     static constexpr auto Name() {
         return "com/avsystem/anjay/impl/NativeLog";
@@ -0,0 +1,85 @@
+/*
+ * Copyright 2020-2024 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "./notify_coalescer.hpp"
+
+#include <utility>
+
+NotifyCoalescer::NotifyCoalescer(avs_time_duration_t window)
+        : window_(window), deadline_(AVS_TIME_MONOTONIC_INVALID), pending_() {}
+
+void NotifyCoalescer::schedule_flush() {
+    if (!avs_time_monotonic_valid(deadline_)) {
+        deadline_ = avs_time_monotonic_add(avs_time_monotonic_now(), window_);
+    }
+}
+
+void NotifyCoalescer::notify_changed(anjay_oid_t oid,
+                                     anjay_iid_t iid,
+                                     anjay_rid_t rid) {
+    ObjectChanges &changes = pending_[oid];
+    if (!changes.instances_changed) {
+        changes.resources.emplace(iid, rid);
+    }
+    schedule_flush();
+}
+
+void NotifyCoalescer::notify_instances_changed(anjay_oid_t oid) {
+    ObjectChanges &changes = pending_[oid];
+    changes.instances_changed = true;
+    changes.resources.clear();
+    schedule_flush();
+}
+
+avs_time_duration_t NotifyCoalescer::time_to_flush() const {
+    if (!avs_time_monotonic_valid(deadline_)) {
+        return AVS_TIME_DURATION_INVALID;
+    }
+    avs_time_duration_t result =
+            avs_time_monotonic_diff(deadline_, avs_time_monotonic_now());
+    return avs_time_duration_less(result, AVS_TIME_DURATION_ZERO)
+                   ? AVS_TIME_DURATION_ZERO
+                   : result;
+}
+
+int NotifyCoalescer::flush_if_due(anjay_t *anjay) {
+    if (!avs_time_monotonic_valid(deadline_)
+            || avs_time_monotonic_before(avs_time_monotonic_now(),
+                                         deadline_)) {
+        return 0;
+    }
+    std::map<anjay_oid_t, ObjectChanges> pending;
+    std::swap(pending, pending_);
+    deadline_ = AVS_TIME_MONOTONIC_INVALID;
+
+    int result = 0;
+    auto update_result = [&](int partial) {
+        if (!result) {
+            result = partial;
+        }
+    };
+    for (const auto &object : pending) {
+        if (object.second.instances_changed) {
+            update_result(anjay_notify_instances_changed(anjay, object.first));
+        }
+        for (const auto &resource : object.second.resources) {
+            update_result(anjay_notify_changed(anjay, object.first,
+                                               resource.first,
+                                               resource.second));
+        }
+    }
+    return result;
+}
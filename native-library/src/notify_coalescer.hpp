@@ -0,0 +1,70 @@
+/*
+ * Copyright 2020-2024 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <anjay/anjay.h>
+
+#include <avsystem/commons/avs_time.h>
+
+#include <map>
+#include <set>
+#include <utility>
+
+/**
+ * Collects notify_changed() and notify_instances_changed() requests and passes
+ * them to Anjay at most once per window, each distinct path only once.
+ *
+ * A change of the Instance set of an Object makes Anjay re-evaluate all
+ * observations within that Object, so it subsumes any pending changes of
+ * Resources in that Object.
+ */
+class NotifyCoalescer {
+    struct ObjectChanges {
+        bool instances_changed;
+        std::set<std::pair<anjay_iid_t, anjay_rid_t>> resources;
+
+        ObjectChanges() : instances_changed(), resources() {}
+    };
+
+    avs_time_duration_t window_;
+    // Time at which the pending changes shall be flushed; invalid if there are
+    // none.
+    avs_time_monotonic_t deadline_;
+    std::map<anjay_oid_t, ObjectChanges> pending_;
+
+    void schedule_flush();
+
+public:
+    explicit NotifyCoalescer(avs_time_duration_t window);
+
+    void notify_changed(anjay_oid_t oid, anjay_iid_t iid, anjay_rid_t rid);
+
+    void notify_instances_changed(anjay_oid_t oid);
+
+    /**
+     * Returns time remaining until the pending changes shall be flushed, or an
+     * invalid duration if there are none.
+     */
+    avs_time_duration_t time_to_flush() const;
+
+    /**
+     * Passes the pending changes to @p anjay, if their window has elapsed.
+     *
+     * @returns 0 on success, or the first error reported by Anjay.
+     */
+    int flush_if_due(anjay_t *anjay);
+};
@@ -0,0 +1,27 @@
+/*
+ * Copyright 2020-2024 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "./observation_watcher.hpp"
+
+void ObservationWatcher::watch(anjay_t *anjay, const Path &path) {
+    if (watched_.find(path) == watched_.end()) {
+        watched_.emplace(path, status_of(anjay, path));
+    }
+}
+
+void ObservationWatcher::unwatch(const Path &path) {
+    watched_.erase(path);
+}
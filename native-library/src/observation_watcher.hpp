@@ -0,0 +1,91 @@
+/*
+ * Copyright 2020-2024 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <anjay/anjay.h>
+
+#include <map>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+/**
+ * Keeps track of the observation status of Resources the application is
+ * interested in, so that it can be told when they start or stop being
+ * observed instead of having to produce values for all of them all the time.
+ *
+ * Observations can only change while Anjay handles incoming messages or runs
+ * scheduled jobs, so poll() only needs to be called after these.
+ */
+class ObservationWatcher {
+public:
+    typedef std::tuple<anjay_oid_t, anjay_iid_t, anjay_rid_t> Path;
+
+    ObservationWatcher() : watched_() {}
+
+    /**
+     * Starts watching @p path. Its current status is taken as the initial
+     * one, so only later changes are reported by poll().
+     */
+    void watch(anjay_t *anjay, const Path &path);
+
+    void unwatch(const Path &path);
+
+    const std::map<Path, anjay_resource_observation_status_t> &
+    watched() const {
+        return watched_;
+    }
+
+    /**
+     * Refreshes status of all watched paths, calling
+     * @p on_change(path, status) for each one that changed since the previous
+     * call. @p on_change is only called after all paths are refreshed, so it
+     * may watch() or unwatch() paths.
+     */
+    template <typename F>
+    void poll(anjay_t *anjay, F &&on_change) {
+        std::vector<std::pair<Path, anjay_resource_observation_status_t>>
+                changes;
+        for (auto &entry : watched_) {
+            const anjay_resource_observation_status_t status =
+                    status_of(anjay, entry.first);
+            if (!equal(status, entry.second)) {
+                entry.second = status;
+                changes.emplace_back(entry.first, status);
+            }
+        }
+        for (const auto &change : changes) {
+            on_change(change.first, change.second);
+        }
+    }
+
+private:
+    std::map<Path, anjay_resource_observation_status_t> watched_;
+
+    static anjay_resource_observation_status_t status_of(anjay_t *anjay,
+                                                         const Path &path) {
+        return anjay_resource_observation_status(anjay, std::get<0>(path),
+                                                 std::get<1>(path),
+                                                 std::get<2>(path));
+    }
+
+    static bool equal(const anjay_resource_observation_status_t &a,
+                      const anjay_resource_observation_status_t &b) {
+        return a.is_observed == b.is_observed && a.min_period == b.min_period
+               && a.max_eval_period == b.max_eval_period;
+    }
+};
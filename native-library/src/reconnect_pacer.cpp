@@ -0,0 +1,67 @@
+/*
+ * Copyright 2020-2024 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "./reconnect_pacer.hpp"
+
+#include <algorithm>
+
+ReconnectPacer::ReconnectPacer()
+        : mutex_(),
+          rate_limit_(),
+          next_slot_(AVS_TIME_MONOTONIC_INVALID),
+          random_(std::random_device{}()) {}
+
+ReconnectPacer &ReconnectPacer::instance() {
+    static ReconnectPacer pacer;
+    return pacer;
+}
+
+void ReconnectPacer::set_rate_limit(double requests_per_second) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    rate_limit_ = std::max(requests_per_second, 0.0);
+    next_slot_ = AVS_TIME_MONOTONIC_INVALID;
+}
+
+avs_time_duration_t
+ReconnectPacer::next_delay(avs_time_duration_t max_jitter) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const avs_time_monotonic_t now = avs_time_monotonic_now();
+    avs_time_monotonic_t target = now;
+
+    int64_t max_jitter_us = 0;
+    if (avs_time_duration_valid(max_jitter)
+            && !avs_time_duration_to_scalar(&max_jitter_us, AVS_TIME_US,
+                                            max_jitter)
+            && max_jitter_us > 0) {
+        target = avs_time_monotonic_add(
+                target,
+                avs_time_duration_from_scalar(
+                        std::uniform_int_distribution<int64_t>(
+                                0, max_jitter_us)(random_),
+                        AVS_TIME_US));
+    }
+
+    if (rate_limit_ > 0.0) {
+        if (avs_time_monotonic_valid(next_slot_)
+                && avs_time_monotonic_before(target, next_slot_)) {
+            target = next_slot_;
+        }
+        next_slot_ = avs_time_monotonic_add(
+                target, avs_time_duration_from_fscalar(1.0 / rate_limit_,
+                                                       AVS_TIME_S));
+    }
+    return avs_time_monotonic_diff(target, now);
+}
@@ -0,0 +1,58 @@
+/*
+ * Copyright 2020-2024 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <avsystem/commons/avs_time.h>
+
+#include <mutex>
+#include <random>
+
+/**
+ * Spreads reconnections and registration updates requested by the application
+ * over time, so that a large number of clients that all react to the same
+ * event (e.g. a server restart) do not flood the server with Register messages
+ * at once.
+ *
+ * Each request is delayed by a random jitter chosen by the client it belongs
+ * to. Additionally, all clients in the process share a rate limit, which is
+ * enforced by handing out consecutive time slots.
+ */
+class ReconnectPacer {
+    std::mutex mutex_;
+    // Zero if there is no rate limit.
+    double rate_limit_;
+    avs_time_monotonic_t next_slot_;
+    std::mt19937_64 random_;
+
+    ReconnectPacer();
+
+public:
+    static ReconnectPacer &instance();
+
+    /**
+     * Sets the maximum number of paced requests per second in the whole
+     * process; zero or less disables the limit.
+     */
+    void set_rate_limit(double requests_per_second);
+
+    /**
+     * Returns how long the next request shall be delayed, given that the
+     * client it belongs to uses @p max_jitter. The result is zero if neither
+     * jitter nor rate limiting is in effect.
+     */
+    avs_time_duration_t next_delay(avs_time_duration_t max_jitter);
+};
@@ -0,0 +1,135 @@
+/*
+ * Copyright 2020-2024 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "./sample_gate.hpp"
+
+#include <cmath>
+
+namespace {
+
+bool is_set(double attr) {
+    return !std::isnan(attr);
+}
+
+bool crossed(double threshold, double previous, double value) {
+    return is_set(threshold) && (previous > threshold) != (value > threshold);
+}
+
+bool satisfies(const anjay_dm_r_attributes_t &attrs,
+               double previous,
+               double value,
+               int64_t elapsed_ns) {
+    if (attrs.common.max_period != ANJAY_ATTRIB_PERIOD_NONE
+            && elapsed_ns >= int64_t(attrs.common.max_period) * 1000000000) {
+        return true;
+    }
+    if (!is_set(attrs.greater_than) && !is_set(attrs.less_than)
+            && !is_set(attrs.step)) {
+        return value != previous;
+    }
+    return crossed(attrs.greater_than, previous, value)
+           || crossed(attrs.less_than, previous, value)
+           || (is_set(attrs.step)
+               && std::fabs(value - previous) >= attrs.step);
+}
+
+} // namespace
+
+void SampleGate::set_attrs(anjay_ssid_t ssid,
+                           anjay_oid_t oid,
+                           anjay_iid_t iid,
+                           anjay_rid_t rid,
+                           const anjay_dm_r_attributes_t &attrs) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_[Path(oid, iid, rid)].attrs[ssid] = attrs;
+}
+
+void SampleGate::clear_attrs(anjay_ssid_t ssid,
+                             anjay_oid_t oid,
+                             anjay_iid_t iid,
+                             anjay_rid_t rid) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(Path(oid, iid, rid));
+    if (it != entries_.end()) {
+        it->second.attrs.erase(ssid);
+    }
+}
+
+void SampleGate::storage_installed() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    storage_installed_ = true;
+}
+
+bool SampleGate::is_storage_installed() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return storage_installed_;
+}
+
+void SampleGate::set_storage_attrs(anjay_ssid_t ssid,
+                                   anjay_oid_t oid,
+                                   anjay_iid_t iid,
+                                   anjay_rid_t rid,
+                                   const anjay_dm_r_attributes_t &attrs) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_[Path(oid, iid, rid)].storage_attrs[ssid] = attrs;
+}
+
+void SampleGate::storage_purged() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto &entry : entries_) {
+        entry.second.storage_attrs.clear();
+    }
+    storage_trusted_ = true;
+}
+
+void SampleGate::storage_modified() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    storage_trusted_ = false;
+}
+
+bool SampleGate::accept(anjay_oid_t oid,
+                        anjay_iid_t iid,
+                        anjay_rid_t rid,
+                        double value,
+                        int64_t timestamp_ns) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Entry &entry = entries_[Path(oid, iid, rid)];
+    const int64_t elapsed_ns = timestamp_ns - entry.last_timestamp_ns;
+    const bool use_storage_attrs =
+            storage_trusted_ && !entry.storage_attrs.empty();
+    bool notify = !entry.notified;
+    if (!notify && entry.attrs.empty() && !use_storage_attrs) {
+        notify = value != entry.last_value;
+    }
+    for (auto it = entry.attrs.begin(); !notify && it != entry.attrs.end();
+         ++it) {
+        notify = satisfies(it->second, entry.last_value, value, elapsed_ns);
+    }
+    if (use_storage_attrs) {
+        for (auto it = entry.storage_attrs.begin();
+             !notify && it != entry.storage_attrs.end();
+             ++it) {
+            notify = satisfies(it->second, entry.last_value, value,
+                               elapsed_ns);
+        }
+    }
+    if (notify) {
+        entry.notified = true;
+        entry.last_value = value;
+        entry.last_timestamp_ns = timestamp_ns;
+    }
+    return notify;
+}
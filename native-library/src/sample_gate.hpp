@@ -0,0 +1,119 @@
+/*
+ * Copyright 2020-2024 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <anjay/dm.h>
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <tuple>
+
+/**
+ * Decides natively whether a new sample of a numeric Resource is worth a
+ * notify_changed() call, according to the Greater Than, Less Than, Step and
+ * Maximum Period attributes known for that Resource, so that high-rate
+ * samples that would not trigger a notification do not reach the data model.
+ *
+ * Attributes are learned from the attribute storage, from Objects that handle
+ * attributes themselves, and from explicit calls. If no attributes are known
+ * for a Resource, every change of its value is passed through.
+ *
+ * Servers may write attributes into the attribute storage without the gate
+ * seeing them, so attributes learned from there are only used until the
+ * storage may have been modified behind the gate's back; see
+ * storage_modified().
+ *
+ * May be used from any thread.
+ */
+class SampleGate {
+    typedef std::tuple<anjay_oid_t, anjay_iid_t, anjay_rid_t> Path;
+
+    struct Entry {
+        std::map<anjay_ssid_t, anjay_dm_r_attributes_t> attrs;
+        std::map<anjay_ssid_t, anjay_dm_r_attributes_t> storage_attrs;
+        bool notified;
+        double last_value;
+        int64_t last_timestamp_ns;
+
+        Entry()
+                : attrs(),
+                  storage_attrs(),
+                  notified(),
+                  last_value(),
+                  last_timestamp_ns() {}
+    };
+
+    std::mutex mutex_;
+    std::map<Path, Entry> entries_;
+    bool storage_installed_;
+    bool storage_trusted_;
+
+public:
+    SampleGate()
+            : mutex_(),
+              entries_(),
+              storage_installed_(),
+              storage_trusted_(true) {}
+
+    void set_attrs(anjay_ssid_t ssid,
+                   anjay_oid_t oid,
+                   anjay_iid_t iid,
+                   anjay_rid_t rid,
+                   const anjay_dm_r_attributes_t &attrs);
+
+    void clear_attrs(anjay_ssid_t ssid,
+                     anjay_oid_t oid,
+                     anjay_iid_t iid,
+                     anjay_rid_t rid);
+
+    void storage_installed();
+
+    bool is_storage_installed();
+
+    void set_storage_attrs(anjay_ssid_t ssid,
+                           anjay_oid_t oid,
+                           anjay_iid_t iid,
+                           anjay_rid_t rid,
+                           const anjay_dm_r_attributes_t &attrs);
+
+    /**
+     * Forgets attributes learned from the attribute storage after it has been
+     * purged, and starts trusting the storage again.
+     */
+    void storage_purged();
+
+    /**
+     * Stops using attributes learned from the attribute storage, as it may
+     * now contain attributes the gate does not know of, e.g. written by a
+     * server or restored from a stream. Samples of Resources that have no
+     * other attributes are then passed through on every change.
+     */
+    void storage_modified();
+
+    /**
+     * Records a sample taken at @p timestamp_ns (on any monotonic clock).
+     *
+     * @returns true if the sample satisfies a notification condition for any
+     *          server; it then becomes the reference for subsequent samples.
+     */
+    bool accept(anjay_oid_t oid,
+                anjay_iid_t iid,
+                anjay_rid_t rid,
+                double value,
+                int64_t timestamp_ns);
+};
@@ -17,6 +17,7 @@
 #pragma once
 
 #include <cstring>
+#include <vector>
 
 #include "../jni_wrapper.hpp"
 
@@ -143,4 +144,124 @@ public:
     }
 };
 
+/**
+ * Keeps direct ByteBuffer views over C/C++-side allocated buffers that are
+ * passed to Java repeatedly - e.g. Anjay's in/out buffers, which stay the same
+ * for the whole lifetime of the client. Instead of creating a fresh
+ * DirectByteBuffer on each call (like BufferView does), a cached view is reused
+ * and only its position and limit are adjusted.
+ *
+ * A request for a region lying within an already cached view is served from
+ * that view, so e.g. subsequent reads into the same buffer at different offsets
+ * do not create new views either.
+ *
+ * If @p read_only is set, the cached views are created with
+ * ByteBuffer.asReadOnlyBuffer(), so that Java code cannot modify the native
+ * buffer through them.
+ */
+class BufferViewCache {
+    BufferViewCache(const BufferViewCache &) = delete;
+    BufferViewCache &operator=(const BufferViewCache &) = delete;
+
+    struct Buffer {
+        static constexpr auto Name() {
+            return "java/nio/Buffer";
+        }
+    };
+
+    struct Entry {
+        char *address;
+        size_t capacity;
+        jni::Global<jni::Object<ByteBuffer>> view;
+    };
+
+    // NOTE: The number of distinct buffers used by a single socket in a single
+    // direction is really small (usually one), so linear search is fine.
+    static constexpr size_t MAX_ENTRIES = 2;
+
+    const bool read_only_;
+    jni::Global<jni::Class<ByteBuffer>> class_;
+    jni::Method<ByteBuffer, jni::Object<Buffer>(jni::jint)> position_;
+    jni::Method<ByteBuffer, jni::Object<Buffer>(jni::jint)> limit_;
+    std::vector<Entry> entries_;
+    size_t next_victim_;
+
+public:
+    explicit BufferViewCache(bool read_only = false)
+            : read_only_(read_only),
+              class_(GlobalContext::call_with_env([](auto &&env) {
+                  return jni::NewGlobal(*env,
+                                        jni::Class<ByteBuffer>::Find(*env));
+              })),
+              position_(GlobalContext::call_with_env([&](auto &&env) {
+                  return class_.GetMethod<jni::Object<Buffer>(jni::jint)>(
+                          *env, "position");
+              })),
+              limit_(GlobalContext::call_with_env([&](auto &&env) {
+                  return class_.GetMethod<jni::Object<Buffer>(jni::jint)>(
+                          *env, "limit");
+              })),
+              entries_(),
+              next_victim_() {}
+
+    /**
+     * Returns a direct ByteBuffer whose remaining() region is exactly
+     * [@p native_buffer, @p native_buffer + @p length).
+     *
+     * CAUTION: The same lifetime and constness rules as for BufferView apply.
+     * Additionally, the returned reference is only valid until the next call
+     * to view() or until the cache is destroyed.
+     */
+    const jni::Global<jni::Object<ByteBuffer>> &view(void *native_buffer,
+                                                       size_t length) {
+        if (length > static_cast<size_t>(
+                             std::numeric_limits<jni::jint>::max())) {
+            avs_throw(IllegalArgumentException(
+                    "Buffer size exceeds jni::jint max value"));
+        }
+        char *address = static_cast<char *>(native_buffer);
+        for (auto &entry : entries_) {
+            if (address >= entry.address
+                    && address + length <= entry.address + entry.capacity) {
+                const jni::jint position =
+                        static_cast<jni::jint>(address - entry.address);
+                GlobalContext::call_with_env([&](auto &&env) {
+                    // limit() goes first, so that position() never exceeds it
+                    entry.view.Call(*env, limit_,
+                                    position + static_cast<jni::jint>(length));
+                    entry.view.Call(*env, position_, position);
+                });
+                return entry.view;
+            }
+        }
+        return insert(address, length).view;
+    }
+
+private:
+    Entry &insert(char *address, size_t length) {
+        Entry entry{ address, length,
+                     GlobalContext::call_with_env([&](auto &&env) {
+                         jni::Local<jni::Object<ByteBuffer>> view{
+                             *env,
+                             &jni::NewDirectByteBuffer(*env, address, length)
+                         };
+                         if (read_only_) {
+                             auto as_read_only = class_.GetMethod<
+                                     jni::Object<ByteBuffer>()>(
+                                     *env, "asReadOnlyBuffer");
+                             view = view.Call(*env, as_read_only);
+                         }
+                         return jni::NewGlobal(*env, view);
+                     }) };
+        if (entries_.size() < MAX_ENTRIES) {
+            entries_.push_back(std::move(entry));
+            return entries_.back();
+        }
+        Entry &victim = entries_[next_victim_];
+        next_victim_ = (next_victim_ + 1) % MAX_ENTRIES;
+        victim = std::move(entry);
+        return victim;
+    }
+};
+
 } // namespace utils
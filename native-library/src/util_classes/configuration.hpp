@@ -27,6 +27,7 @@
 #include "./dtls_handshake_timeouts.hpp"
 #include "./dtls_version.hpp"
 #include "./duration.hpp"
+#include "./lwm2m_version_config.hpp"
 
 namespace utils {
 
@@ -80,6 +81,27 @@ struct Configuration {
             return get_value<bool>("useConnectionId");
         }
 
+        bool get_adaptive_tx_params() {
+            return get_value<bool>("adaptiveTxParams");
+        }
+
+        std::optional<avs_time_duration_t> get_notify_coalescing_window() {
+            auto value =
+                    get_optional_value<Duration>("notifyCoalescingWindow");
+            if (value) {
+                return std::make_optional(Duration::into_native(*value));
+            }
+            return {};
+        }
+
+        std::optional<avs_time_duration_t> get_reconnect_jitter() {
+            auto value = get_optional_value<Duration>("reconnectJitter");
+            if (value) {
+                return std::make_optional(Duration::into_native(*value));
+            }
+            return {};
+        }
+
         std::optional<avs_coap_udp_tx_params_t> get_udp_tx_params() {
             auto value = get_optional_value<CoapUdpTxParams>("udpTxParams");
             if (value) {
@@ -116,6 +138,17 @@ struct Configuration {
             return {};
         }
 
+        std::optional<anjay_lwm2m_version_config_t>
+        get_lwm2m_version_config() {
+            auto value = get_optional_value<Lwm2mVersionConfig>(
+                    "lwm2mVersionConfig");
+            if (value) {
+                return std::make_optional(
+                        Lwm2mVersionConfig::into_native(*value));
+            }
+            return {};
+        }
+
         std::optional<avs_net_ssl_version_t> get_dtls_version() {
             auto value = get_optional_value<DtlsVersion>("dtlsVersion");
             if (value) {
@@ -23,8 +23,10 @@ namespace utils {
 template <typename T, typename... Args>
 auto construct(const Args &... args) {
     return GlobalContext::call_with_env([&](auto &&env) {
-        auto clazz = jni::Class<T>::Find(*env);
-        auto ctor = clazz.template GetConstructor<
+        // Looked up once per class and signature. The class is pinned by a
+        // global reference, so the constructor ID remains valid.
+        static const auto &clazz = jni::Class<T>::Singleton(*env);
+        static const auto ctor = clazz.template GetConstructor<
                 typename jni::RemoveUnique<Args>::Type...>(*env);
         return clazz.New(*env, ctor, args...);
     });
@@ -15,7 +15,9 @@
  */
 
 #include "./exception.hpp"
-#include "./accessor_base.hpp"
+
+#include <algorithm>
+#include <atomic>
 
 namespace utils {
 
@@ -40,6 +42,8 @@ std::string get_file_msg(const char *file) {
     }
 }
 
+std::atomic<jni::jsize> MAX_LOGGED_STACK_FRAMES{ 16 };
+
 void log_and_clear_java_exception(JNIEnv &env,
                                   avs_log_level_t level,
                                   const char *file,
@@ -50,26 +54,38 @@ void log_and_clear_java_exception(JNIEnv &env,
     // because there's a pending exception.
     jni::ExceptionClear(env);
 
-    auto accessor = AccessorBase<Throwable>{ exception };
-    auto stack_trace =
-            accessor.get_method<jni::Array<jni::Object<StackTraceElement>>()>(
-                    "getStackTrace")();
-    auto exception_name = jni::Make<std::string>(
-            env, accessor.get_method<jni::String()>("toString")());
+    static const auto &throwable_class = jni::Class<Throwable>::Singleton(env);
+    static const auto to_string =
+            throwable_class.GetMethod<jni::String()>(env, "toString");
+    static const auto get_stack_trace = throwable_class.GetMethod<
+            jni::Array<jni::Object<StackTraceElement>>()>(env,
+                                                          "getStackTrace");
+    static const auto &frame_class =
+            jni::Class<StackTraceElement>::Singleton(env);
+    static const auto frame_to_string =
+            frame_class.GetMethod<jni::String()>(env, "toString");
 
+    auto exception_name =
+            jni::Make<std::string>(env, exception.Call(env, to_string));
     avs_log_internal_l__(level, "anjay_jni", file, line,
                          "Java exception: %s occurred. Stack trace:",
                          exception_name.c_str());
-    for (jni::jsize i = 0; i < stack_trace.Length(env); ++i) {
+
+    auto stack_trace = exception.Call(env, get_stack_trace);
+    const jni::jsize frames = stack_trace.Length(env);
+    const jni::jsize logged_frames = std::min(
+            frames, MAX_LOGGED_STACK_FRAMES.load(std::memory_order_relaxed));
+    for (jni::jsize i = 0; i < logged_frames; ++i) {
         avs_log_internal_l__(
                 level, "anjay_jni", file, line, "%s",
-                jni::Make<std::string>(env,
-                                       AccessorBase<StackTraceElement>{
-                                               stack_trace.Get(env, i) }
-                                               .get_method<jni::String()>(
-                                                       "toString")())
+                jni::Make<std::string>(env, stack_trace.Get(env, i).Call(
+                                                    env, frame_to_string))
                         .c_str());
     }
+    if (logged_frames < frames) {
+        avs_log_internal_l__(level, "anjay_jni", file, line, "... %ld more",
+                             static_cast<long>(frames - logged_frames));
+    }
 } catch (...) {
     if (jni::ExceptionCheck(env)) {
         jni::ExceptionClear(env);
@@ -84,6 +100,19 @@ void log_and_clear_java_exception(JNIEnv &env,
 void avs_log_and_clear_exception_impl(avs_log_level_t level,
                                       const char *file,
                                       unsigned line) {
+    if (!avs_log_should_log__(level, "anjay_jni")) {
+        // Nothing would be printed, so don't bother rendering the exception,
+        // which for Java ones takes a few JNI calls per stack frame.
+        try {
+            GlobalContext::call_with_env([](auto &&env) {
+                if (jni::ExceptionCheck(*env)) {
+                    jni::ExceptionClear(*env);
+                }
+            });
+        } catch (...) {
+        }
+        return;
+    }
     // Java exception case
     try {
         if (GlobalContext::call_with_env([=](auto &&env) {
@@ -117,4 +146,9 @@ void avs_log_and_clear_exception_impl(avs_log_level_t level,
 
 } // namespace detail
 
+void set_max_logged_stack_frames(jni::jint frames) {
+    detail::MAX_LOGGED_STACK_FRAMES.store(std::max<jni::jint>(frames, 0),
+                                          std::memory_order_relaxed);
+}
+
 } // namespace utils
@@ -97,8 +97,27 @@ void avs_log_and_clear_exception_impl(avs_log_level_t level,
                                       const char *file,
                                       unsigned line);
 
+template <typename T>
+void throw_new(JNIEnv &env, const char *str) {
+    env.ThrowNew(reinterpret_cast<::jclass>(
+                         jni::Class<T>::Singleton(env).get()),
+                 str);
+}
+
+template <typename T>
+void throw_new(const char *str) {
+    GlobalContext::call_with_env(
+            [&](auto &&env) { throw_new<T>(*env, str); });
+}
+
 } // namespace detail
 
+/**
+ * Sets the maximum number of stack frames logged for Java exceptions caught in
+ * native code.
+ */
+void set_max_logged_stack_frames(jni::jint frames);
+
 } // namespace utils
 
 struct AnjayException : public jni::PendingJavaException {
@@ -116,10 +135,12 @@ struct AnjayException : public jni::PendingJavaException {
 };
 
 struct ClassCastException : public jni::PendingJavaException {
+    static constexpr auto Name() {
+        return "java/lang/ClassCastException";
+    }
+
     ClassCastException(const char *str) : jni::PendingJavaException() {
-        GlobalContext::call_with_env([&](auto &&env) {
-            env->ThrowNew(env->FindClass("java/lang/ClassCastException"), str);
-        });
+        utils::detail::throw_new<ClassCastException>(str);
     }
 
     ClassCastException(const std::string &str)
@@ -127,16 +148,17 @@ struct ClassCastException : public jni::PendingJavaException {
 };
 
 struct IllegalArgumentException : public jni::PendingJavaException {
+    static constexpr auto Name() {
+        return "java/lang/IllegalArgumentException";
+    }
+
     IllegalArgumentException(JNIEnv &env, const char *str)
             : jni::PendingJavaException() {
-        env.ThrowNew(env.FindClass("java/lang/IllegalArgumentException"), str);
+        utils::detail::throw_new<IllegalArgumentException>(env, str);
     }
 
     IllegalArgumentException(const char *str) : jni::PendingJavaException() {
-        GlobalContext::call_with_env([&](auto &&env) {
-            env->ThrowNew(env->FindClass("java/lang/IllegalArgumentException"),
-                          str);
-        });
+        utils::detail::throw_new<IllegalArgumentException>(str);
     }
 
     IllegalArgumentException(JNIEnv &env, const std::string &str)
@@ -147,16 +169,17 @@ struct IllegalArgumentException : public jni::PendingJavaException {
 };
 
 struct IllegalStateException : public jni::PendingJavaException {
+    static constexpr auto Name() {
+        return "java/lang/IllegalStateException";
+    }
+
     IllegalStateException(JNIEnv &env, const char *str)
             : jni::PendingJavaException() {
-        env.ThrowNew(env.FindClass("java/lang/IllegalStateException"), str);
+        utils::detail::throw_new<IllegalStateException>(env, str);
     }
 
     IllegalStateException(const char *str) : jni::PendingJavaException() {
-        GlobalContext::call_with_env([&](auto &&env) {
-            env->ThrowNew(env->FindClass("java/lang/IllegalStateException"),
-                          str);
-        });
+        utils::detail::throw_new<IllegalStateException>(str);
     }
 
     IllegalStateException(JNIEnv &env, const std::string &str)
@@ -167,13 +190,13 @@ struct IllegalStateException : public jni::PendingJavaException {
 };
 
 struct UnsupportedOperationException : public jni::PendingJavaException {
+    static constexpr auto Name() {
+        return "java/lang/UnsupportedOperationException";
+    }
+
     UnsupportedOperationException(const char *str)
             : jni::PendingJavaException() {
-        GlobalContext::call_with_env([&](auto &&env) {
-            env->ThrowNew(env->FindClass(
-                                  "java/lang/UnsupportedOperationException"),
-                          str);
-        });
+        utils::detail::throw_new<UnsupportedOperationException>(str);
     }
 
     UnsupportedOperationException(const std::string &str)
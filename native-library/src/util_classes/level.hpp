@@ -21,6 +21,7 @@
 #include "../jni_wrapper.hpp"
 
 #include <unordered_map>
+#include <utility>
 
 #include "./accessor_base.hpp"
 
@@ -48,6 +49,22 @@ struct Level {
             return get_enum_instance(MAPPING[level]);
         });
     }
+
+    // Returns the lowest native level that is still logged by a Java logger
+    // with given Level.intValue(), according to the mapping above.
+    static avs_log_level_t threshold_into_native(jni::jint value) {
+        static const std::pair<jni::jint, avs_log_level_t> THRESHOLDS[] = {
+            { 300, AVS_LOG_TRACE },   { 500, AVS_LOG_DEBUG },
+            { 800, AVS_LOG_INFO },    { 900, AVS_LOG_WARNING },
+            { 1000, AVS_LOG_ERROR }
+        };
+        for (const auto &threshold : THRESHOLDS) {
+            if (value <= threshold.first) {
+                return threshold.second;
+            }
+        }
+        return AVS_LOG_QUIET;
+    }
 };
 
 } // namespace utils
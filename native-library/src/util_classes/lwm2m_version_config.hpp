@@ -0,0 +1,77 @@
+/*
+ * Copyright 2020-2024 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "../jni_wrapper.hpp"
+
+#include <string>
+#include <unordered_map>
+
+#include <anjay/anjay.h>
+
+#include "./accessor_base.hpp"
+#include "./exception.hpp"
+
+namespace utils {
+
+struct Lwm2mVersion {
+    static constexpr auto Name() {
+        return "com/avsystem/anjay/Anjay$Lwm2mVersion";
+    }
+
+    static anjay_lwm2m_version_t
+    into_native(const jni::Object<Lwm2mVersion> &instance) {
+        static std::unordered_map<std::string, anjay_lwm2m_version_t> MAPPING{
+            { "VERSION_1_0", ANJAY_LWM2M_VERSION_1_0 },
+            { "VERSION_1_1", ANJAY_LWM2M_VERSION_1_1 }
+        };
+        return GlobalContext::call_with_env([&instance](auto &&env) {
+            auto clazz = jni::Class<Lwm2mVersion>::Find(*env);
+            auto value = jni::Make<std::string>(
+                    *env, instance.Call(*env,
+                                        clazz.template GetMethod<jni::String()>(
+                                                *env, "name")));
+            auto mapped_to = MAPPING.find(value);
+            if (mapped_to == MAPPING.end()) {
+                avs_throw(IllegalArgumentException("Unsupported enum value: "
+                                                   + value));
+            }
+            return mapped_to->second;
+        });
+    }
+};
+
+struct Lwm2mVersionConfig {
+    static constexpr auto Name() {
+        return "com/avsystem/anjay/Anjay$Lwm2mVersionConfig";
+    }
+
+    static anjay_lwm2m_version_config_t
+    into_native(const jni::Object<Lwm2mVersionConfig> &instance) {
+        auto accessor = AccessorBase<Lwm2mVersionConfig>{ instance };
+        anjay_lwm2m_version_config_t result{};
+        result.minimum_version = Lwm2mVersion::into_native(
+                accessor.get_value<jni::Object<Lwm2mVersion>>(
+                        "minimumVersion"));
+        result.maximum_version = Lwm2mVersion::into_native(
+                accessor.get_value<jni::Object<Lwm2mVersion>>(
+                        "maximumVersion"));
+        return result;
+    }
+};
+
+} // namespace utils
@@ -48,7 +48,8 @@ struct NativeSocketEntry {
                 reinterpret_cast<jni::jlong>(entry->socket),
                 static_cast<jni::jint>(entry->ssid),
                 static_cast<jni::jboolean>(entry->queue_mode),
-                static_cast<jni::jint>(strtol(port, NULL, 10)));
+                static_cast<jni::jint>(strtol(port, NULL, 10)),
+                static_cast<jni::jboolean>(backend.has_pending_output()));
     }
 };
 
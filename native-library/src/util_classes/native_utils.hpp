@@ -72,6 +72,21 @@ struct NativeUtils {
                         "waitUntilReady")(channel, Duration::into_java(timeout),
                                           waitStates.into_java()));
     }
+
+    /**
+     * Returns index of the first of @p channels that became ready, or -1 if
+     * none of them did before @p timeout elapsed.
+     */
+    static int wait_until_any_ready(
+            const jni::Array<jni::Object<SelectableChannel>> &channels,
+            avs_time_duration_t timeout,
+            ReadyState waitStates) {
+        return AccessorBase<NativeUtils>::get_static_method<jni::jint(
+                jni::Array<jni::Object<SelectableChannel>>,
+                jni::Object<Duration>, jni::Object<ReadyState>)>(
+                "waitUntilAnyReady")(channels, Duration::into_java(timeout),
+                                     waitStates.into_java());
+    }
 };
 
 } // namespace utils
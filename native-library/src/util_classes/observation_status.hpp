@@ -0,0 +1,52 @@
+/*
+ * Copyright 2020-2024 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "../jni_wrapper.hpp"
+
+#include <anjay/anjay.h>
+
+#include "./construct.hpp"
+
+namespace utils {
+
+struct ObservationStatus {
+    static constexpr auto Name() {
+        return "com/avsystem/anjay/Anjay$ObservationStatus";
+    }
+
+    static jni::Local<jni::Object<ObservationStatus>>
+    New(anjay_oid_t oid,
+        anjay_iid_t iid,
+        anjay_rid_t rid,
+        const anjay_resource_observation_status_t &status) {
+        return construct<ObservationStatus>(
+                static_cast<jni::jint>(oid), static_cast<jni::jint>(iid),
+                static_cast<jni::jint>(rid),
+                static_cast<jni::jboolean>(status.is_observed),
+                static_cast<jni::jint>(status.min_period),
+                static_cast<jni::jint>(status.max_eval_period));
+    }
+};
+
+struct ObservationListener {
+    static constexpr auto Name() {
+        return "com/avsystem/anjay/Anjay$ObservationListener";
+    }
+};
+
+} // namespace utils
@@ -0,0 +1,54 @@
+/*
+ * Copyright 2020-2024 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "../jni_wrapper.hpp"
+
+#include "./accessor_base.hpp"
+#include "./duration.hpp"
+
+namespace utils {
+
+struct SendConfiguration {
+    static constexpr auto Name() {
+        return "com/avsystem/anjay/AnjaySend$Configuration";
+    }
+
+    class Accessor : public AccessorBase<SendConfiguration> {
+    public:
+        explicit Accessor(const jni::Object<utils::SendConfiguration> &config)
+                : AccessorBase(config) {}
+
+        int get_ssid() {
+            return get_value<int>("ssid");
+        }
+
+        int get_max_samples() {
+            return get_value<int>("maxSamples");
+        }
+
+        std::optional<avs_time_duration_t> get_max_delay() {
+            auto value = get_optional_value<Duration>("maxDelay");
+            if (value) {
+                return std::make_optional(Duration::into_native(*value));
+            }
+            return {};
+        }
+    };
+};
+
+} // namespace utils
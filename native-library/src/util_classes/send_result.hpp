@@ -0,0 +1,63 @@
+/*
+ * Copyright 2020-2024 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "../jni_wrapper.hpp"
+
+#include "./accessor_base.hpp"
+
+#include <anjay/lwm2m_send.h>
+
+namespace utils {
+
+struct SendResult {
+    static constexpr auto Name() {
+        return "com/avsystem/anjay/AnjaySend$Result";
+    }
+
+    static jni::Local<jni::Object<SendResult>> into_java(int result) {
+        switch (result) {
+        case ANJAY_SEND_SUCCESS:
+            return get("SUCCESS");
+        case ANJAY_SEND_TIMEOUT:
+            return get("TIMEOUT");
+        case ANJAY_SEND_ABORT:
+            return get("ABORTED");
+        case ANJAY_SEND_DEFERRED_ERROR:
+            return get("DEFERRED_ERROR");
+        default:
+            return get(result > 0 ? "REJECTED" : "FAILED");
+        }
+    }
+
+    static jni::Local<jni::Object<SendResult>> failed() {
+        return get("FAILED");
+    }
+
+private:
+    static jni::Local<jni::Object<SendResult>> get(const char *name) {
+        return GlobalContext::call_with_env([&](auto &&env) {
+            auto clazz = jni::Class<SendResult>::Find(*env);
+            return clazz.Get(
+                    *env,
+                    clazz.template GetStaticField<jni::Object<SendResult>>(
+                            *env, name));
+        });
+    }
+};
+
+} // namespace utils
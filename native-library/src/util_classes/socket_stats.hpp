@@ -0,0 +1,74 @@
+/*
+ * Copyright 2020-2024 AVSystem <avsystem@avsystem.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "../jni_wrapper.hpp"
+
+#include <avsystem/commons/avs_errno.h>
+
+#include "./accessor_base.hpp"
+#include "./construct.hpp"
+#include "./duration.hpp"
+#include "./hash_map.hpp"
+#include "./map.hpp"
+
+#include "../compat/socket_stats.hpp"
+
+namespace utils {
+
+struct SocketStats {
+    static constexpr auto Name() {
+        return "com/avsystem/anjay/Anjay$SocketStats";
+    }
+
+    static jni::Local<jni::Object<SocketStats>>
+    New(jni::JNIEnv &env, const compat::SocketStats &stats) {
+        auto clazz = jni::Class<HashMap>::Find(env);
+        auto errors = clazz.New(env, clazz.GetConstructor<>(env));
+        auto put = AccessorBase<HashMap>{ errors }
+                           .get_method<jni::Object<>(jni::Object<>,
+                                                     jni::Object<>)>("put");
+        for (const auto &error : stats.errors) {
+            put(jni::Make<jni::String>(
+                        env, avs_strerror(avs_errno(error.first))),
+                jni::Box(env, static_cast<jni::jlong>(error.second)));
+        }
+
+        auto make_duration = [&](avs_time_duration_t duration) {
+            if (!avs_time_duration_valid(duration)) {
+                return jni::Local<jni::Object<Duration>>(env, nullptr);
+            }
+            return Duration::into_java(duration);
+        };
+
+        return construct<SocketStats>(
+                static_cast<jni::jlong>(stats.bytes_sent),
+                static_cast<jni::jlong>(stats.bytes_received),
+                static_cast<jni::jlong>(stats.send_calls),
+                static_cast<jni::jlong>(stats.receive_calls),
+                static_cast<jni::jlong>(stats.receive_timeouts),
+                static_cast<jni::jlong>(stats.send_stalls),
+                Duration::into_java(stats.wait_time),
+                jni::Cast(env, jni::Class<Map>::Find(env), errors),
+                static_cast<jni::jlong>(stats.rtt.samples),
+                make_duration(stats.rtt.smoothed_rtt),
+                make_duration(stats.rtt.rtt_variation),
+                make_duration(stats.rtt.retransmission_timeout));
+    }
+};
+
+} // namespace utils
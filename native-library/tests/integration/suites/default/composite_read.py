@@ -0,0 +1,80 @@
+# -*- coding: utf-8 -*-
+#
+# Copyright 2020-2024 AVSystem <avsystem@avsystem.com>
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+
+import socket
+
+import jni_test
+from framework.lwm2m.senml_cbor import *
+from framework.lwm2m_test import *
+
+from .test_object import OID, RID
+
+PATHS = ['/%d/1/%d' % (OID.Test, rid)
+         for rid in (RID.Test.Int, RID.Test.Long, RID.Test.Double,
+                     RID.Test.String)]
+
+
+def senml_names(entries):
+    names = []
+    base_name = ''
+    for entry in entries:
+        base_name = entry.get(SenmlLabel.BASE_NAME, base_name)
+        names.append(base_name + entry.get(SenmlLabel.NAME, ''))
+    return names
+
+
+class CompositeReadMessageCountTest(jni_test.LocalSingleServerTest,
+                                    test_suite.Lwm2mDmOperations):
+    def setUp(self):
+        super().setUp(maximum_version='1.1')
+
+    def recv_all(self, timeout_s=0.5):
+        """
+        Receives datagrams until none arrives for TIMEOUT_S seconds.
+        """
+        datagrams = []
+        while True:
+            try:
+                datagrams.append(self.serv.recv(timeout_s=timeout_s))
+            except socket.timeout:
+                return datagrams
+
+    def runTest(self):
+        # Reading Resources one by one takes a datagram per path...
+        single_datagrams = 0
+        for path in PATHS:
+            req = Lwm2mRead(path, accept=coap.ContentFormat.APPLICATION_LWM2M_TLV)
+            self.serv.send(req)
+            datagrams = self.recv_all()
+            self.assertEqual(len(datagrams), 1)
+            self.assertMsgEqual(Lwm2mContent.matching(req)(), datagrams[0])
+            single_datagrams += len(datagrams)
+        self.assertEqual(single_datagrams, len(PATHS))
+
+        # ...while Read-Composite gets all of them in a single one
+        req = Lwm2mReadComposite(
+            uri_path='',
+            accept=coap.ContentFormat.APPLICATION_LWM2M_SENML_CBOR,
+            content=CBOR.serialize(
+                [{SenmlLabel.NAME: path} for path in PATHS]))
+        self.serv.send(req)
+        datagrams = self.recv_all()
+        self.assertEqual(len(datagrams), 1)
+        self.assertMsgEqual(Lwm2mContent.matching(req)(), datagrams[0])
+        self.assertEqual(sorted(senml_names(CBOR.parse(datagrams[0].content))),
+                         sorted(PATHS))
+        self.assertLess(len(datagrams), single_datagrams)
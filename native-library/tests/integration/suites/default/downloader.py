@@ -18,6 +18,7 @@ import concurrent.futures
 import contextlib
 import http.server
 import os
+import re
 import socket
 import threading
 import time
@@ -251,6 +252,64 @@ class CoapDownloadRetransmissions(CoapDownload.Test):
             self.assertEqual(f.read(), DUMMY_PAYLOAD)
 
 
+class CoapDownloadHostStub:
+    class Test(CoapDownload.Test):
+        STUB_HOST = 'stub.invalid'
+
+        def stub_uri(self):
+            return self.register_resource('/', DUMMY_PAYLOAD).replace(
+                '127.0.0.1', self.STUB_HOST)
+
+        def download(self):
+            self.communicate('download %s %s' % (self.stub_uri(), self.tempfile.name))
+            self.wait_until_socket_count(2, timeout_s=15)
+
+            # make sure the download is actually done
+            self.wait_until_downloads_finished()
+            with open(self.tempfile.name, 'rb') as f:
+                self.assertEqual(f.read(), DUMMY_PAYLOAD)
+
+        def assertHostStubLookups(self, count):
+            self.communicate('host-stub-lookups')
+            self.assertIsNotNone(self.read_log_until_match(
+                regex=re.escape(b'HOST_STUB_LOOKUPS==%d\n' % count),
+                timeout_s=2))
+
+
+class CoapDownloadHostStubCachesLookups(CoapDownloadHostStub.Test):
+    def runTest(self):
+        self.communicate('set-host-stub %s 127.0.0.1 2000 0' % self.STUB_HOST)
+
+        self.download()
+        self.assertHostStubLookups(1)
+
+        # the cached result is reused...
+        self.download()
+        self.assertHostStubLookups(1)
+
+        # ...until it expires
+        time.sleep(2.5)
+        self.download()
+        self.assertHostStubLookups(2)
+
+
+class CoapDownloadHostStubCoalescesLookups(CoapDownloadHostStub.Test):
+    def runTest(self):
+        # lookups take longer than the 10 second connect timeout
+        self.communicate('set-host-stub %s 127.0.0.1 60000 12000' % self.STUB_HOST)
+
+        # the first download gives up waiting for the lookup...
+        self.communicate('download %s %s' % (self.stub_uri(), self.tempfile.name))
+        self.assertIsNotNone(self.read_log_until_match(
+            regex=re.escape(b'HOST_STUB_LOOKUP==%s,1' % self.STUB_HOST.encode()),
+            timeout_s=5))
+
+        # ...and the second one waits for the same lookup instead of starting
+        # another one
+        self.download()
+        self.assertHostStubLookups(1)
+
+
 class HttpDownload:
     class Test(jni_test.LocalSingleServerTest):
         def make_request_handler(self):
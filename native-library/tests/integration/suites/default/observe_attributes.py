@@ -119,3 +119,26 @@ class ObserveWithDefaultAttributesTest(jni_test.LocalSingleServerTest,
         self.assertEqual(pkt.content, counter_pkt.content)
         # Up until they're reset
         self.communicate('set-attrs /%d/%d/%d 1' % (OID.Test, 1, RID.Test.Int))
+
+
+class IngestSampleWithServerOverriddenAttributesTest(jni_test.LocalSingleServerTest,
+                                                     test_suite.Lwm2mDmOperations):
+    def runTest(self):
+        # Initialize resource
+        self.communicate('ingest-sample 5.5')
+
+        # Thresholds set via public API...
+        self.communicate('set-attrs /%d/%d/%d 1 gt=100' % (OID.Test, 1, RID.Test.Double))
+        # ...are overridden by the server
+        self.write_attributes(self.serv, oid=OID.Test, iid=1, rid=RID.Test.Double,
+                              query=['gt=10'])
+
+        self.observe(self.serv, oid=OID.Test, iid=1, rid=RID.Test.Double,
+                     accept=coap.ContentFormat.TEXT_PLAIN)
+
+        # Sample crosses only the threshold written by the server, so it must
+        # not be dropped by natively evaluated stale attributes
+        self.communicate('ingest-sample 50.5')
+        pkt = self.serv.recv(timeout_s=3)
+        self.assertEqual(pkt.code, coap.Code.RES_CONTENT)
+        self.assertEqual(pkt.content, b'50.5')
@@ -0,0 +1,68 @@
+# -*- coding: utf-8 -*-
+#
+# Copyright 2020-2024 AVSystem <avsystem@avsystem.com>
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+
+import re
+import socket
+
+import jni_test
+from framework.lwm2m.senml_cbor import *
+from framework.lwm2m_test import *
+
+from .test_object import OID, RID
+
+
+class SendTest(jni_test.LocalSingleServerTest):
+    def setUp(self):
+        super().setUp(maximum_version='1.1')
+
+    def add_samples(self, count):
+        for value in range(count):
+            self.communicate('send-add %d 1 %d %d'
+                             % (OID.Test, RID.Test.Int, value))
+
+    def finish_send(self, req, sample_count):
+        self.assertMsgEqual(Lwm2mSend(), req)
+        self.assertEqual(len(CBOR.parse(req.content)), sample_count)
+        self.serv.send(Lwm2mChanged.matching(req)())
+        self.assertIsNotNone(self.read_log_until_match(
+            regex=re.escape(b'SEND_FINISHED==%d,SUCCESS' % sample_count),
+            timeout_s=5))
+
+
+class SendMaxSamplesTest(SendTest):
+    def runTest(self):
+        self.communicate('send-config 1 3')
+
+        self.add_samples(2)
+        with self.assertRaises(socket.timeout):
+            self.serv.recv(timeout_s=1)
+
+        # The third sample fills up the batch
+        self.add_samples(1)
+        self.finish_send(self.serv.recv(), 3)
+
+
+class SendMaxDelayTest(SendTest):
+    def runTest(self):
+        self.communicate('send-config 1 100 2000')
+
+        self.add_samples(2)
+        with self.assertRaises(socket.timeout):
+            self.serv.recv(timeout_s=1)
+
+        # The batch is not full, but maxDelay passes
+        self.finish_send(self.serv.recv(timeout_s=3), 2)